@@ -1,9 +1,26 @@
 QT += widgets
 
-SOURCES += main.cpp
+SOURCES += main.cpp \
+    telemetryworker.cpp \
+    videosurface.cpp
 
 HEADERS += \
-    adasdisplay.h
+    adasdisplay.h \
+    telemetryworker.h \
+    videosurface.h
+
+# Zero-copy rear-view scan-out needs GStreamer's GL sink; without it the
+# rear-view page keeps the placeholder label.
+packagesExist(gstreamer-1.0 gstreamer-video-1.0) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += gstreamer-1.0 gstreamer-video-1.0
+    DEFINES += HAVE_GSTREAMER
+}
+
+# shared telemetry protocol header (detector <-> display)
+INCLUDEPATH += ../common
+
+unix:LIBS += -lrt
 
 CONFIG += c++17
 
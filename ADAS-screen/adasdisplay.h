@@ -5,6 +5,26 @@
 #include <QLabel>
 #include <QStackedWidget>
 #include <QTimer>
+#include <QThread>
+#include <QPalette>
+#include "telemetry_bus.hpp"
+#include "telemetryworker.h"
+#include "videosurface.h"
+
+// Everything the dashboard page renders, as plain values. Incoming
+// telemetry mutates an instance of this; the render pass diffs it
+// against the last rendered copy and only touches widgets whose field
+// actually changed, so an idle dashboard costs no repaints at all.
+struct DashboardState
+{
+    enum LdwStatus { LdwOk, LdwWarning, LdwNoLane };
+
+    LdwStatus ldw = LdwOk;
+    bool bsdWarning = false;
+    int speedKmh = 0;
+    QString tsrSign = "No Sign";
+    bool autoLightOn = false;
+};
 
 class ADASDisplay : public QWidget
 {
@@ -19,10 +39,13 @@ protected:
 
 private slots:
     void updateSimulatedData();
+    void onTelemetryRecord(telemetry::Record record);
+    void onTelemetryConnected();
 
 private:
     void initUI();
     void updateDisplayMode();
+    void renderDashboard();
 
     QStackedWidget *stackedWidget;
     QWidget *dashboardPage;
@@ -33,7 +56,8 @@ private:
     QLabel *autoLightLabel;
 
     QWidget *rearViewPage;
-    QLabel *rearViewLabel;
+    QLabel *rearViewLabel;          // placeholder when no camera is up
+    VideoSurface *rearViewSurface;  // zero-copy camera scan-out
 
     QWidget *navigationPage;
     QLabel *navigationLabel;
@@ -42,5 +66,22 @@ private:
     QTimer *timer;
     int currentModeIndex;
     QStringList modes;
+
+    // live lane telemetry, ingested and coalesced off the GUI thread by
+    // TelemetryWorker; telemetryLive stays false (LDW simulated) until
+    // the worker attaches to the detector's bus
+    QThread *telemetryThread;
+    TelemetryWorker *telemetryWorker;
+    bool telemetryLive;
+
+    // damage tracking: pending state vs what the labels currently show.
+    // Colors come from these prebuilt palettes; setPalette skips the
+    // stylesheet re-polish/repaint that setStyleSheet forces.
+    DashboardState state;
+    DashboardState renderedState;
+    bool renderedValid;
+    QPalette normalPalette;
+    QPalette warningPalette;
+    QPalette cautionPalette;
 };
 #endif // ADASDISPLAY_H
@@ -11,10 +11,20 @@ ADASDisplay::ADASDisplay(QWidget *parent)
 {
     setWindowTitle("ADAS Display");
     setWindowState(Qt::WindowFullScreen); // Make it full screen
-    setStyleSheet("background-color: #1a1a1a; color: #e0e0e0;"); // Dark theme
+    // Dark theme background only: label text colors are palettes now, and
+    // a window-level "color:" stylesheet rule would override them all.
+    setStyleSheet("background-color: #1a1a1a;");
+
+    // Prebuilt palettes; swapping a palette skips the stylesheet
+    // re-polish and full repaint that setStyleSheet forces per call.
+    normalPalette.setColor(QPalette::WindowText, QColor("#e0e0e0"));
+    warningPalette.setColor(QPalette::WindowText, Qt::red);
+    cautionPalette.setColor(QPalette::WindowText, QColor("orange"));
+    renderedValid = false;
 
     stackedWidget = new QStackedWidget(this);
     initUI();
+    renderDashboard(); // paint the initial state once
 
     currentModeIndex = 0;
     modes << "dashboard" << "rear_view" << "navigation";
@@ -25,6 +35,19 @@ ADASDisplay::ADASDisplay(QWidget *parent)
     connect(timer, &QTimer::timeout, this, &ADASDisplay::updateSimulatedData);
     timer->start(1000); // Update every 1 second
 
+    // Live lane telemetry: all bus I/O happens on the worker thread,
+    // which coalesces bursts and posts at most one queued record per
+    // display refresh; the GUI thread only ever runs onTelemetryRecord.
+    telemetryLive = false;
+    telemetryThread = new QThread(this);
+    telemetryWorker = new TelemetryWorker();
+    telemetryWorker->moveToThread(telemetryThread);
+    connect(telemetryThread, &QThread::started, telemetryWorker, &TelemetryWorker::run);
+    connect(telemetryThread, &QThread::finished, telemetryWorker, &QObject::deleteLater);
+    connect(telemetryWorker, &TelemetryWorker::connected, this, &ADASDisplay::onTelemetryConnected);
+    connect(telemetryWorker, &TelemetryWorker::recordReady, this, &ADASDisplay::onTelemetryRecord);
+    telemetryThread->start();
+
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     mainLayout->setContentsMargins(0, 0, 0, 0);
     mainLayout->setSpacing(0);
@@ -33,6 +56,9 @@ ADASDisplay::ADASDisplay(QWidget *parent)
 
 ADASDisplay::~ADASDisplay()
 {
+    telemetryWorker->stop();
+    telemetryThread->quit();
+    telemetryThread->wait();
 }
 
 void ADASDisplay::initUI()
@@ -51,6 +77,8 @@ void ADASDisplay::initUI()
     bsdLabel->setFont(QFont("Arial", 24, QFont::Bold));
     ldwLabel->setAlignment(Qt::AlignCenter);
     bsdLabel->setAlignment(Qt::AlignCenter);
+    ldwLabel->setPalette(normalPalette);
+    bsdLabel->setPalette(normalPalette);
     topWarningLayout->addWidget(ldwLabel);
     topWarningLayout->addWidget(bsdLabel);
     dashboardLayout->addLayout(topWarningLayout);
@@ -59,6 +87,7 @@ void ADASDisplay::initUI()
     speedLabel = new QLabel("SPEED: 0 km/h");
     speedLabel->setFont(QFont("Arial", 72, QFont::Bold));
     speedLabel->setAlignment(Qt::AlignCenter);
+    speedLabel->setPalette(normalPalette);
     dashboardLayout->addWidget(speedLabel);
 
     // Bottom section: TSR, Auto Light
@@ -69,6 +98,8 @@ void ADASDisplay::initUI()
     autoLightLabel->setFont(QFont("Arial", 24));
     tsrLabel->setAlignment(Qt::AlignCenter);
     autoLightLabel->setAlignment(Qt::AlignCenter);
+    tsrLabel->setPalette(normalPalette);
+    autoLightLabel->setPalette(normalPalette);
     bottomInfoLayout->addWidget(tsrLabel);
     bottomInfoLayout->addWidget(autoLightLabel);
     dashboardLayout->addLayout(bottomInfoLayout);
@@ -78,10 +109,21 @@ void ADASDisplay::initUI()
     // --- Rear View Camera Mode ---
     rearViewPage = new QWidget();
     QVBoxLayout *rearViewLayout = new QVBoxLayout(rearViewPage);
+    rearViewLayout->setContentsMargins(0, 0, 0, 0);
+    rearViewSurface = new VideoSurface(QString(), rearViewPage);
     rearViewLabel = new QLabel("REAR VIEW CAMERA FEED");
     rearViewLabel->setFont(QFont("Arial", 48, QFont::Bold));
     rearViewLabel->setAlignment(Qt::AlignCenter);
-    rearViewLayout->addWidget(rearViewLabel);
+    rearViewLabel->setPalette(normalPalette);
+    if (rearViewSurface->isLive()) {
+        // live camera scan-out; frames never touch the CPU
+        rearViewLayout->addWidget(rearViewSurface);
+        rearViewLabel->hide();
+    } else {
+        // no camera / no GStreamer: keep the placeholder
+        rearViewSurface->hide();
+        rearViewLayout->addWidget(rearViewLabel);
+    }
     stackedWidget->addWidget(rearViewPage); // Index 1
 
     // --- Navigation Mode ---
@@ -93,6 +135,8 @@ void ADASDisplay::initUI()
     lapCounterLabel = new QLabel("LAP: 0/0");
     lapCounterLabel->setFont(QFont("Arial", 36));
     lapCounterLabel->setAlignment(Qt::AlignCenter);
+    navigationLabel->setPalette(normalPalette);
+    lapCounterLabel->setPalette(normalPalette);
     navigationLayout->addWidget(navigationLabel);
     navigationLayout->addWidget(lapCounterLabel);
     stackedWidget->addWidget(navigationPage); // Index 2
@@ -116,38 +160,97 @@ void ADASDisplay::keyPressEvent(QKeyEvent *event)
     }
 }
 
+// The worker attached to the detector's bus; real data owns the LDW
+// field from here on.
+void ADASDisplay::onTelemetryConnected()
+{
+    telemetryLive = true;
+    state.ldw = DashboardState::LdwOk;
+    renderDashboard();
+}
+
+// One coalesced record per refresh window, already the newest the
+// detector published; everything here is cheap GUI-thread work.
+void ADASDisplay::onTelemetryRecord(telemetry::Record record)
+{
+    if (record.departure)
+        state.ldw = DashboardState::LdwWarning;
+    else if (record.lane_count == 0)
+        state.ldw = DashboardState::LdwNoLane;
+    else
+        state.ldw = DashboardState::LdwOk;
+    renderDashboard();
+}
+
 void ADASDisplay::updateSimulatedData()
 {
-    if (currentModeIndex == 0) { // Only update dashboard elements in dashboard mode
-        // Simulate LDW/BSD warnings
-        if (QRandomGenerator::global()->generateDouble() < 0.1) { // 10% chance of warning
+    if (currentModeIndex != 0) // Only update dashboard elements in dashboard mode
+        return;
+
+    // Simulate LDW warnings only while the real detector is not
+    // connected; once the bus is up, onTelemetryRecord() owns that field.
+    if (!telemetryLive) {
+        state.ldw = QRandomGenerator::global()->generateDouble() < 0.1 // 10% chance of warning
+                        ? DashboardState::LdwWarning
+                        : DashboardState::LdwOk;
+    }
+
+    state.bsdWarning = QRandomGenerator::global()->generateDouble() < 0.05; // 5% chance of BSD warning
+
+    // Simulate speed (Cruise Control)
+    state.speedKmh = QRandomGenerator::global()->bounded(60, 121); // 60 to 120
+
+    // Simulate TSR
+    QStringList signs = {"No Sign", "Speed 50", "Stop Sign", "Yield"};
+    state.tsrSign = signs.at(QRandomGenerator::global()->bounded(signs.size()));
+
+    // Simulate Auto Light
+    state.autoLightOn = QRandomGenerator::global()->generateDouble() < 0.5;
+
+    renderDashboard();
+}
+
+// Diff-and-apply: a label is written only when its backing field changed
+// since the last render, and colors swap prebuilt palettes. Producers
+// mutate `state` as often as they like; an unchanged dashboard costs a
+// handful of comparisons and zero widget traffic.
+void ADASDisplay::renderDashboard()
+{
+    bool force = !renderedValid;
+
+    if (force || state.ldw != renderedState.ldw) {
+        switch (state.ldw) {
+        case DashboardState::LdwWarning:
             ldwLabel->setText("LDW: WARNING!");
-            ldwLabel->setStyleSheet("color: red; font-weight: bold;");
-        } else {
+            ldwLabel->setPalette(warningPalette);
+            break;
+        case DashboardState::LdwNoLane:
+            ldwLabel->setText("LDW: NO LANE");
+            ldwLabel->setPalette(cautionPalette);
+            break;
+        default:
             ldwLabel->setText("LDW: OK");
-            ldwLabel->setStyleSheet("color: #e0e0e0;");
+            ldwLabel->setPalette(normalPalette);
+            break;
         }
+    }
 
-        if (QRandomGenerator::global()->generateDouble() < 0.05) { // 5% chance of BSD warning
-            bsdLabel->setText("BSD: OBJECT!");
-            bsdLabel->setStyleSheet("color: orange; font-weight: bold;");
-        } else {
-            bsdLabel->setText("BSD: OK");
-            bsdLabel->setStyleSheet("color: #e0e0e0;");
-        }
+    if (force || state.bsdWarning != renderedState.bsdWarning) {
+        bsdLabel->setText(state.bsdWarning ? "BSD: OBJECT!" : "BSD: OK");
+        bsdLabel->setPalette(state.bsdWarning ? cautionPalette : normalPalette);
+    }
 
-        // Simulate speed (Cruise Control)
-        int currentSpeed = QRandomGenerator::global()->bounded(60, 121); // 60 to 120
-        speedLabel->setText(QString("SPEED: %1 km/h").arg(currentSpeed));
+    if (force || state.speedKmh != renderedState.speedKmh)
+        speedLabel->setText(QString("SPEED: %1 km/h").arg(state.speedKmh));
 
-        // Simulate TSR
-        QStringList signs = {"No Sign", "Speed 50", "Stop Sign", "Yield"};
-        tsrLabel->setText(QString("TSR: %1").arg(signs.at(QRandomGenerator::global()->bounded(signs.size()))));
+    if (force || state.tsrSign != renderedState.tsrSign)
+        tsrLabel->setText(QString("TSR: %1").arg(state.tsrSign));
 
-        // Simulate Auto Light
-        QString lightStatus = (QRandomGenerator::global()->generateDouble() < 0.5) ? "ON" : "OFF";
-        autoLightLabel->setText(QString("Auto Light: %1").arg(lightStatus));
-    }
+    if (force || state.autoLightOn != renderedState.autoLightOn)
+        autoLightLabel->setText(QString("Auto Light: %1").arg(state.autoLightOn ? "ON" : "OFF"));
+
+    renderedState = state;
+    renderedValid = true;
 }
 
 int main(int argc, char *argv[])
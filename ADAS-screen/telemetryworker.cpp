@@ -0,0 +1,56 @@
+#include "telemetryworker.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <poll.h>
+
+// One update per display refresh is plenty; anything faster is invisible.
+static const qint64 kCoalesceWindowMs = 16;
+
+void TelemetryWorker::run()
+{
+    // the detector may come up minutes after the display does
+    while (!stopping.load() && !sub.open())
+        QThread::msleep(500);
+    if (stopping.load())
+        return;
+    emit connected();
+
+    QElapsedTimer clock;
+    clock.start();
+
+    telemetry::Record pending;
+    bool pendingValid = false;
+    qint64 lastEmitMs = -kCoalesceWindowMs;
+
+    while (!stopping.load()) {
+        // With an update pending, wait only until the window closes;
+        // otherwise sleep until the producer pokes the fd (bounded so
+        // stop() is honored).
+        qint64 nowMs = clock.elapsed();
+        int timeout = pendingValid
+                          ? qMax<qint64>(0, lastEmitMs + kCoalesceWindowMs - nowMs)
+                          : 500;
+
+        struct pollfd pfd;
+        pfd.fd = sub.notification_fd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        ::poll(&pfd, 1, timeout);
+
+        if (pfd.revents & POLLIN) {
+            // coalesce: drain every wakeup byte, keep only the newest
+            // record the seqlock serves
+            sub.drain();
+            if (sub.latest(pending))
+                pendingValid = true;
+        }
+
+        nowMs = clock.elapsed();
+        if (pendingValid && nowMs - lastEmitMs >= kCoalesceWindowMs) {
+            emit recordReady(pending);
+            pendingValid = false;
+            lastEmitMs = nowMs;
+        }
+    }
+}
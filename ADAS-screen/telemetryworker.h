@@ -0,0 +1,46 @@
+#ifndef TELEMETRYWORKER_H
+#define TELEMETRYWORKER_H
+
+#include <QObject>
+#include <QMetaType>
+#include <atomic>
+#include "telemetry_bus.hpp"
+
+Q_DECLARE_METATYPE(telemetry::Record)
+
+// Telemetry ingestion off the GUI thread. The worker owns the bus
+// subscription and blocks in poll() on the wakeup fd, so a stalled or
+// bursty producer can never freeze rendering. Bursts are coalesced:
+// within each ~16 ms window only the newest record survives, and one
+// queued recordReady() crosses to the GUI thread per window — a 500 Hz
+// source becomes at most ~60 widget updates a second.
+class TelemetryWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    TelemetryWorker() : stopping(false)
+    {
+        qRegisterMetaType<telemetry::Record>("telemetry::Record");
+    }
+
+    // Signal-safe; run() notices within one poll timeout.
+    void stop() { stopping.store(true); }
+
+public slots:
+    // Entry point, invoked via QThread::started. Retries attaching to
+    // the bus until the detector creates it, then loops until stop().
+    void run();
+
+signals:
+    // At most one per coalescing window, delivered queued on the GUI
+    // thread with the newest record seen in that window.
+    void recordReady(telemetry::Record record);
+    void connected();
+
+private:
+    std::atomic<bool> stopping;
+    telemetry::Subscriber sub;
+};
+
+#endif // TELEMETRYWORKER_H
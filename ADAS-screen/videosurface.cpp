@@ -0,0 +1,108 @@
+#include "videosurface.h"
+
+#ifdef HAVE_GSTREAMER
+#include <gst/video/videooverlay.h>
+#endif
+
+VideoSurface::VideoSurface(const QString &pipelineDesc, QWidget *parent)
+    : QWidget(parent), live(false)
+{
+#ifdef HAVE_GSTREAMER
+    pipeline = nullptr;
+    sink = nullptr;
+
+    static bool gstInited = false;
+    if (!gstInited) {
+        gst_init(nullptr, nullptr);
+        gstInited = true;
+    }
+
+    // glimagesink renders into our native window; the sink must not
+    // fight the Qt paint system for it
+    setAttribute(Qt::WA_NativeWindow);
+    setAttribute(Qt::WA_PaintOnScreen);
+    setAttribute(Qt::WA_NoSystemBackground);
+
+    QString desc = pipelineDesc;
+    if (desc.isEmpty()) {
+        const char *env = getenv("ADAS_REAR_CAM");
+        // v4l2src io-mode=dmabuf hands the capture buffers straight to
+        // the GL stack; sync=false always scans out the newest frame
+        desc = env && *env
+                   ? QString::fromLocal8Bit(env)
+                   : "v4l2src device=/dev/video1 io-mode=dmabuf ! "
+                     "video/x-raw,width=1920,height=1080,framerate=30/1 ! "
+                     "glimagesink name=sink sync=false";
+    }
+
+    GError *error = nullptr;
+    pipeline = gst_parse_launch(desc.toLocal8Bit().constData(), &error);
+    if (!pipeline) {
+        qWarning("rear view pipeline failed: %s", error ? error->message : "unknown");
+        if (error)
+            g_error_free(error);
+        return;
+    }
+    sink = gst_bin_get_by_name(GST_BIN(pipeline), "sink");
+    if (!sink) {
+        qWarning("rear view pipeline has no element named \"sink\"");
+        gst_object_unref(pipeline);
+        pipeline = nullptr;
+        return;
+    }
+    live = true;
+#else
+    Q_UNUSED(pipelineDesc);
+#endif
+}
+
+VideoSurface::~VideoSurface()
+{
+#ifdef HAVE_GSTREAMER
+    if (pipeline) {
+        gst_element_set_state(pipeline, GST_STATE_NULL);
+        gst_object_unref(sink);
+        gst_object_unref(pipeline);
+    }
+#endif
+}
+
+bool VideoSurface::isLive() const
+{
+    return live;
+}
+
+void VideoSurface::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+#ifdef HAVE_GSTREAMER
+    if (!pipeline)
+        return;
+    // bind the sink to our window before frames start flowing
+    gst_video_overlay_set_window_handle(GST_VIDEO_OVERLAY(sink), winId());
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        qWarning("rear view pipeline refused to start");
+        live = false;
+    }
+#endif
+}
+
+void VideoSurface::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+#ifdef HAVE_GSTREAMER
+    // no point decoding 1080p30 while another page is up
+    if (pipeline)
+        gst_element_set_state(pipeline, GST_STATE_READY);
+#endif
+}
+
+QPaintEngine *VideoSurface::paintEngine() const
+{
+#ifdef HAVE_GSTREAMER
+    // the sink owns every pixel of this window
+    if (live)
+        return nullptr;
+#endif
+    return QWidget::paintEngine();
+}
@@ -0,0 +1,46 @@
+#ifndef VIDEOSURFACE_H
+#define VIDEOSURFACE_H
+
+#include <QWidget>
+
+#ifdef HAVE_GSTREAMER
+#include <gst/gst.h>
+#endif
+
+// Zero-copy video surface for the rear-view camera. The decoder output
+// stays on the GPU: GStreamer scans frames out through glimagesink,
+// which imports the capture buffers as DMA-buf/EGL textures and renders
+// into this widget's native window — no per-frame CPU pixel copy, no
+// QImage conversion. sync=false scans out the newest frame immediately,
+// keeping the pipeline inside the one-frame latency budget the
+// reversing-camera 200 ms glass-to-glass requirement leaves us.
+//
+// The pipeline runs only while the widget is visible, and when
+// GStreamer is unavailable (or the pipeline fails) the widget stays
+// inert and isLive() returns false so the caller can keep a placeholder.
+class VideoSurface : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // pipelineDesc must end in a video sink named "sink"; empty picks
+    // the ADAS_REAR_CAM environment override or the default v4l2 chain.
+    explicit VideoSurface(const QString &pipelineDesc = QString(), QWidget *parent = nullptr);
+    ~VideoSurface();
+
+    bool isLive() const;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    QPaintEngine *paintEngine() const override;
+
+private:
+#ifdef HAVE_GSTREAMER
+    GstElement *pipeline;
+    GstElement *sink;
+#endif
+    bool live;
+};
+
+#endif // VIDEOSURFACE_H
@@ -0,0 +1,83 @@
+#ifndef ADR_CONTROLLER_H
+#define ADR_CONTROLLER_H
+
+#include <stdint.h>
+
+// Adaptive data rate for the telemetry link. The radio parameters walk
+// a fixed ladder from the most robust step (long range, slow) to the
+// fastest, driven by the SNR of acknowledged packets and by losses:
+//
+//  - step DOWN the ladder (faster) only after kGoodStreak consecutive
+//    ACKs whose SNR margin over the current step's demodulation floor
+//    exceeds kStepDownMarginDb — enough headroom that the next step
+//    (about 2.5 dB less sensitive) still has margin;
+//  - step UP (more robust) after kLossStreak consecutive losses.
+//
+// The streak counters are the hysteresis: one lucky packet near the pit
+// or one fade in the far corner never flips the rate back and forth.
+
+struct AdrStep {
+  uint8_t sf;
+  long bandwidth_hz;
+  int8_t demod_floor_db;  // approx. SNR at which this step still demodulates
+};
+
+// Robust -> fast. Floors are the SX127x datasheet figures.
+const AdrStep kAdrLadder[] = {
+  {10, 125000L, -15},
+  {9,  125000L, -12},
+  {8,  125000L, -10},
+  {7,  125000L, -7},   // the old fixed configuration
+  {7,  250000L, -7},
+};
+const uint8_t kAdrLadderSize = sizeof(kAdrLadder) / sizeof(kAdrLadder[0]);
+
+class AdrController {
+ public:
+  // Start on the old fixed SF7/125k step: proven on the test track, and
+  // the controller moves off it in either direction as evidence arrives.
+  AdrController() : index(3), goodStreak(0), lossStreak(0) {}
+
+  uint8_t spreadingFactor() const { return kAdrLadder[index].sf; }
+  long signalBandwidth() const { return kAdrLadder[index].bandwidth_hz; }
+
+  // Feed the SNR reported for an acknowledged packet. Returns true when
+  // the step changed and the radio needs reprogramming.
+  bool onAck(float snr_db) {
+    lossStreak = 0;
+    if (snr_db - kAdrLadder[index].demod_floor_db >= kStepDownMarginDb) {
+      goodStreak++;
+    } else {
+      goodStreak = 0;
+    }
+    if (goodStreak >= kGoodStreak && index + 1 < kAdrLadderSize) {
+      index++;
+      goodStreak = 0;
+      return true;
+    }
+    return false;
+  }
+
+  // Feed one unacknowledged report. Returns true when the step changed.
+  bool onLoss() {
+    goodStreak = 0;
+    lossStreak++;
+    if (lossStreak >= kLossStreak && index > 0) {
+      index--;
+      lossStreak = 0;
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  static const uint8_t kGoodStreak = 5;
+  static const uint8_t kLossStreak = 3;
+  static const int8_t kStepDownMarginDb = 10;
+
+  uint8_t index;
+  uint8_t goodStreak;
+  uint8_t lossStreak;
+};
+
+#endif // ADR_CONTROLLER_H
@@ -0,0 +1,91 @@
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Compact binary telemetry frame for the LoRa link, shared between the
+// firmware and the ground-side parser (plain C++/stdint, no Arduino
+// dependency). Replaces the printf-formatted ASCII reports: a frame is
+// a fixed 14 bytes on air versus 40-60 for the text form, roughly
+// tripling reports per second inside the same SF7 duty-cycle budget.
+//
+// Layout, little-endian, all offsets in bytes:
+//   0: uint8  magic   (0xA5)
+//   1: uint8  version (TELEMETRY_VERSION)
+//   2: uint16 seq              rolling sequence number
+//   4: uint16 speed_kmh_x10    vehicle speed, 0.1 km/h steps
+//   6: uint16 battery_mv       pack voltage in millivolts
+//   8: int16  motor_temp_c_x10 motor temperature, 0.1 C steps, signed
+//  10: uint16 rpm
+//  12: uint16 crc              CRC16-CCITT over bytes 0..11
+
+#define TELEMETRY_MAGIC 0xA5
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_FRAME_SIZE 14
+
+struct TelemetryReading {
+  uint16_t seq;
+  uint16_t speed_kmh_x10;
+  uint16_t battery_mv;
+  int16_t motor_temp_c_x10;
+  uint16_t rpm;
+};
+
+// CRC16-CCITT (poly 0x1021, init 0xFFFF), bitwise: no table to keep in
+// flash, and 12 bytes per frame is nothing at these rates.
+inline uint16_t telemetry_crc16(const uint8_t *data, uint8_t len) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t n = 0; n < len; n++) {
+    crc ^= (uint16_t)data[n] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+inline void telemetry_put16(uint8_t *p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+inline uint16_t telemetry_get16(const uint8_t *p) {
+  return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+// Serializes a reading into out[TELEMETRY_FRAME_SIZE]; returns the
+// frame length.
+inline uint8_t telemetry_encode(const TelemetryReading &reading, uint8_t *out) {
+  out[0] = TELEMETRY_MAGIC;
+  out[1] = TELEMETRY_VERSION;
+  telemetry_put16(out + 2, reading.seq);
+  telemetry_put16(out + 4, reading.speed_kmh_x10);
+  telemetry_put16(out + 6, reading.battery_mv);
+  telemetry_put16(out + 8, (uint16_t)reading.motor_temp_c_x10);
+  telemetry_put16(out + 10, reading.rpm);
+  telemetry_put16(out + 12, telemetry_crc16(out, 12));
+  return TELEMETRY_FRAME_SIZE;
+}
+
+// Parses and validates a received frame: length, magic, version and
+// CRC all have to match. Corrupt or foreign packets return false.
+inline bool telemetry_decode(const uint8_t *data, uint8_t len, TelemetryReading &reading) {
+  if (len != TELEMETRY_FRAME_SIZE) {
+    return false;
+  }
+  if (data[0] != TELEMETRY_MAGIC || data[1] != TELEMETRY_VERSION) {
+    return false;
+  }
+  if (telemetry_get16(data + 12) != telemetry_crc16(data, 12)) {
+    return false;
+  }
+  reading.seq = telemetry_get16(data + 2);
+  reading.speed_kmh_x10 = telemetry_get16(data + 4);
+  reading.battery_mv = telemetry_get16(data + 6);
+  reading.motor_temp_c_x10 = (int16_t)telemetry_get16(data + 8);
+  reading.rpm = telemetry_get16(data + 10);
+  return true;
+}
+
+#endif // TELEMETRY_FRAME_H
@@ -0,0 +1,59 @@
+#ifndef TX_QUEUE_H
+#define TX_QUEUE_H
+
+#include <Arduino.h>
+#include <string.h>
+
+// Ring buffer of outgoing LoRa frames. Single producer (loop() / sensor
+// code pushes at any time), single consumer (the TX pump, which runs
+// from loop() with interrupts masked and from the DIO0 TxDone ISR).
+// Indexes are single bytes on a single-core Cortex-M, so the SPSC
+// volatile head/tail handshake needs no further locking.
+
+#define TX_QUEUE_DEPTH 8   // power of two
+#define TX_FRAME_MAX 48    // fits comfortably in one SF7 packet
+
+struct TxFrame {
+  uint8_t len;
+  uint8_t data[TX_FRAME_MAX];
+};
+
+class TxQueue {
+ public:
+  TxQueue() : head(0), tail(0) {}
+
+  // Producer side. Returns false (frame dropped) when full or oversized;
+  // telemetry is periodic, so dropping beats blocking the sampler.
+  bool push(const uint8_t *data, uint8_t len) {
+    if (len > TX_FRAME_MAX) {
+      return false;
+    }
+    uint8_t next = (tail + 1) & (TX_QUEUE_DEPTH - 1);
+    if (next == head) {
+      return false;  // full
+    }
+    memcpy(frames[tail].data, data, len);
+    frames[tail].len = len;
+    tail = next;  // publish only after the payload is in place
+    return true;
+  }
+
+  // Consumer side; call from the ISR or with interrupts masked.
+  bool pop(TxFrame &out) {
+    if (head == tail) {
+      return false;
+    }
+    out = frames[head];
+    head = (head + 1) & (TX_QUEUE_DEPTH - 1);
+    return true;
+  }
+
+  bool empty() const { return head == tail; }
+
+ private:
+  volatile uint8_t head;
+  volatile uint8_t tail;
+  TxFrame frames[TX_QUEUE_DEPTH];
+};
+
+#endif // TX_QUEUE_H
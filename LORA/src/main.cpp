@@ -1,5 +1,8 @@
 #include <SPI.h>
 #include <LoRa.h>
+#include "tx_queue.h"
+#include "telemetry_frame.h"
+#include "adr_controller.h"
 
 // STM32 Nucleo F411RE pin definitions for LoRa module
 // Using SPI1: SCK=PA5 (D13), MISO=PA6 (D12), MOSI=PA7 (D11)
@@ -12,6 +15,109 @@
 
 int counter = 0;
 
+// Interrupt-driven transmit: frames go into the ring queue, the pump
+// hands one to the radio with endPacket(true) (non-blocking), and the
+// DIO0 TxDone interrupt chains the next frame the moment the previous
+// one leaves the air. loop() never waits on the radio.
+TxQueue txQueue;
+volatile bool txBusy = false;
+
+// Starts the next queued frame if the radio is idle. Runs from the
+// TxDone ISR, and from the main context with interrupts masked.
+void pumpTxQueue() {
+  if (txBusy) {
+    return;
+  }
+  static TxFrame frame;  // single consumer, so one scratch frame is safe
+  if (!txQueue.pop(frame)) {
+    return;
+  }
+  txBusy = true;
+  LoRa.beginPacket();
+  LoRa.write(frame.data, frame.len);
+  LoRa.endPacket(true);  // async; DIO0 rises when the packet is out
+}
+
+// DIO0 rising edge: previous packet is fully transmitted.
+void onTxDone() {
+  txBusy = false;
+  pumpTxQueue();
+}
+
+// Producer entry point for loop() and sensor code.
+bool queueFrame(const uint8_t *data, uint8_t len) {
+  noInterrupts();  // the pump and queue tail race with the TxDone ISR
+  bool queued = txQueue.push(data, len);
+  pumpTxQueue();
+  interrupts();
+  return queued;
+}
+
+// Adaptive data rate: the ground station acknowledges each telemetry
+// frame with a 3-byte reply (ACK_MAGIC + seq); the controller walks the
+// SF/bandwidth ladder from ACK SNR and losses (adr_controller.h).
+#define ACK_MAGIC 0xA6
+
+AdrController adr;
+uint16_t lastSeqSent = 0;
+bool ackPending = false;
+bool adrDirty = false;
+
+// Reprograms the radio to the controller's current step. Both sides
+// must hop together, so the ground station applies the same controller
+// logic to the frames it sees. Deferred while a packet is on the air.
+void applyAdrStep() {
+  noInterrupts();
+  bool busy = txBusy;
+  interrupts();
+  if (busy || !txQueue.empty()) {
+    adrDirty = true;  // retry from loop() once the queue drains
+    return;
+  }
+  LoRa.setSpreadingFactor(adr.spreadingFactor());
+  LoRa.setSignalBandwidth(adr.signalBandwidth());
+  adrDirty = false;
+  Serial.print("ADR: SF");
+  Serial.print(adr.spreadingFactor());
+  Serial.print(" @ ");
+  Serial.print(adr.signalBandwidth() / 1000);
+  Serial.println(" kHz");
+}
+
+// Polls for an ACK of the last report; runs only while the radio is
+// idle between transmissions. parsePacket() clears the IRQ flags and
+// forces the radio into RX, which would abort an async endPacket(true)
+// still on the air — TxDone would never fire and the TX chain would
+// wedge — and its SPI traffic must not interleave with the TxDone ISR's.
+void pollAck() {
+  if (!ackPending) {
+    return;
+  }
+  noInterrupts();
+  bool busy = txBusy || !txQueue.empty();
+  interrupts();
+  if (busy) {
+    return;
+  }
+  int packetSize = LoRa.parsePacket();
+  if (packetSize != 3) {
+    while (packetSize-- > 0) {
+      LoRa.read();  // drain foreign traffic
+    }
+    return;
+  }
+  uint8_t magic = LoRa.read();
+  uint16_t seq = LoRa.read();
+  seq |= (uint16_t)LoRa.read() << 8;
+  if (magic != ACK_MAGIC || !ackPending || seq != lastSeqSent) {
+    return;
+  }
+  ackPending = false;
+  if (adr.onAck(LoRa.packetSnr())) {
+    applyAdrStep();
+  }
+}
+
 void setup() {
   Serial.begin(115200);
   while (!Serial);
@@ -96,14 +202,20 @@ void setup() {
   LoRa.setTxPower(20);
   Serial.println("TX Power set to 20dBm");
   
-  // Optional: Set spreading factor (6-12, higher = longer range but slower)
-  LoRa.setSpreadingFactor(7);
-  Serial.println("Spreading Factor set to 7");
-  
-  // Optional: Set signal bandwidth (7.8, 10.4, 15.6, 20.8, 31.25, 41.7, 62.5, 125, 250, 500 kHz)
-  LoRa.setSignalBandwidth(125E3);
-  Serial.println("Signal Bandwidth set to 125 kHz");
-  
+  // Spreading factor and bandwidth come from the ADR controller; it
+  // starts on the old fixed SF7/125 kHz step and adapts from there.
+  LoRa.setSpreadingFactor(adr.spreadingFactor());
+  LoRa.setSignalBandwidth(adr.signalBandwidth());
+  Serial.print("ADR initial step: SF");
+  Serial.print(adr.spreadingFactor());
+  Serial.print(" @ ");
+  Serial.print(adr.signalBandwidth() / 1000);
+  Serial.println(" kHz");
+
+  // TxDone on DIO0 drives the transmit chain
+  LoRa.onTxDone(onTxDone);
+  Serial.println("TxDone interrupt armed on DIO0");
+
   Serial.println("Ready to send packets!");
   
   // Add a small delay before starting the main loop
@@ -111,36 +223,52 @@ void setup() {
   Serial.println("Setup complete, starting main loop...");
 }
 
+// Fills one reading from the vehicle sensors. The sensor harness is not
+// wired into this board yet, so the values are stand-ins; replace each
+// field's source as the ADC/CAN hookups land.
+void sampleTelemetry(TelemetryReading &reading) {
+  reading.seq = (uint16_t)counter;
+  reading.speed_kmh_x10 = 0;
+  reading.battery_mv = 0;
+  reading.motor_temp_c_x10 = 0;
+  reading.rpm = 0;
+}
+
 void loop() {
-  Serial.print("Sending packet: ");
-  Serial.println(counter);
-  Serial.flush(); // Ensure serial output is sent
+  // Sensor acquisition runs here at full rate now; the radio never
+  // blocks the loop, it drains the queue from the TxDone interrupt.
 
-  // Send packet with error checking
-  Serial.println("Starting packet transmission...");
-  
-  if (LoRa.beginPacket()) {
-    Serial.println("Packet begin successful");
-    LoRa.print("Hello World #");
-    LoRa.print(counter);
-    
-    if (LoRa.endPacket()) {
-      Serial.print("Packet sent successfully: Hello World #");
-      Serial.println(counter);
+  pollAck();
+  if (adrDirty) {
+    applyAdrStep();
+  }
+
+  static unsigned long lastReport = 0;
+  unsigned long now = millis();
+  if (now - lastReport >= 2000) {
+    lastReport = now;
+
+    // the previous report had a full interval to get acknowledged;
+    // still pending counts as a loss for the data-rate controller
+    if (ackPending && adr.onLoss()) {
+      applyAdrStep();
+    }
+
+    // 14-byte binary frame (telemetry_frame.h) instead of the old
+    // ASCII report; the ground side decodes with telemetry_decode()
+    TelemetryReading reading;
+    sampleTelemetry(reading);
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    uint8_t len = telemetry_encode(reading, frame);
+    if (queueFrame(frame, len)) {
+      lastSeqSent = reading.seq;
+      ackPending = true;
+      Serial.print("Queued telemetry frame, seq ");
+      Serial.println(reading.seq);
     } else {
-      Serial.println("ERROR: Failed to send packet!");
+      Serial.print("ERROR: TX queue full, dropped frame ");
+      Serial.println(reading.seq);
     }
-  } else {
-    Serial.println("ERROR: Failed to begin packet!");
+    counter++;
   }
-  
-  counter++;
-  
-  Serial.println("Entering delay...");
-  Serial.flush(); // Ensure all output is sent before delay
-  
-  // Wait 2 seconds before sending next packet
-  delay(2000); // Increased delay to 2 seconds
-  
-  Serial.println("Delay complete, looping...");
 }
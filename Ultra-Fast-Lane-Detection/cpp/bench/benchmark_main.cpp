@@ -0,0 +1,136 @@
+// Headless benchmark for the lane detection pipeline. Runs
+// RunLaneDetectionBatch over a video (or loops a fixed frame count),
+// without any imshow/waitKey gating, and reports p50/p95/p99 latency per
+// stage plus sustained FPS as machine-readable JSON so regressions can be
+// tracked across model and driver updates.
+//
+// Usage: ufld_bench [video] [warmup_frames] [measure_frames] [batch]
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core.hpp"
+#include "opencv2/videoio.hpp"
+#include "detector.hpp"
+
+using namespace std;
+using namespace cv;
+
+namespace
+{
+
+double percentile(vector<double> samples, double p)
+{
+    if (samples.empty())
+        return 0;
+    sort(samples.begin(), samples.end());
+    size_t idx = static_cast<size_t>(p * (samples.size() - 1) / 100.0 + 0.5);
+    return samples[idx];
+}
+
+void print_stage_json(const string &name, const vector<double> &samples, bool last = false)
+{
+    cout << "    \"" << name << "\": {"
+         << "\"p50_ms\": " << percentile(samples, 50) << ", "
+         << "\"p95_ms\": " << percentile(samples, 95) << ", "
+         << "\"p99_ms\": " << percentile(samples, 99) << "}"
+         << (last ? "" : ",") << endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    string video = argc > 1 ? argv[1] : "/data/video/dout.mp4";
+    int warmup_frames = argc > 2 ? atoi(argv[2]) : 50;
+    int measure_frames = argc > 3 ? atoi(argv[3]) : 500;
+    int batch = argc > 4 ? atoi(argv[4]) : 1;
+
+    InitDetector();
+
+    VideoCapture cap(video);
+    if (!cap.isOpened())
+    {
+        cerr << "cannot open " << video << endl;
+        return 1;
+    }
+
+    // Reads one batch worth of frames, rewinding the video when it runs
+    // out so long measurement runs work on short clips.
+    vector<double> decode_samples;
+    auto read_batch = [&](bool timed) -> vector<Mat>
+    {
+        auto t0 = chrono::steady_clock::now();
+        vector<Mat> frames;
+        while ((int)frames.size() < batch)
+        {
+            Mat frame;
+            if (!cap.read(frame))
+            {
+                cap.set(CAP_PROP_POS_FRAMES, 0);
+                if (!cap.read(frame))
+                    break;
+            }
+            frames.push_back(frame);
+        }
+        if (timed)
+        {
+            decode_samples.push_back(
+                chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+        }
+        return frames;
+    };
+
+    // Warmup: first iterations pay cuDNN autotuning and allocator growth.
+    for (int i = 0; i < warmup_frames; i++)
+    {
+        auto frames = read_batch(false);
+        if (frames.empty())
+            break;
+        RunLaneDetectionBatch(frames);
+    }
+
+    vector<double> preprocess_samples, h2d_samples, forward_samples, postprocess_samples, total_samples;
+
+    auto bench_start = chrono::steady_clock::now();
+    int processed = 0;
+    for (int i = 0; i < measure_frames; i++)
+    {
+        auto frames = read_batch(true);
+        if (frames.empty())
+            break;
+
+        StageTimings timings;
+        auto t0 = chrono::steady_clock::now();
+        RunLaneDetectionBatch(frames, &timings);
+        total_samples.push_back(
+            chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+
+        preprocess_samples.push_back(timings.preprocess_ms);
+        h2d_samples.push_back(timings.h2d_ms);
+        forward_samples.push_back(timings.forward_ms);
+        postprocess_samples.push_back(timings.postprocess_ms);
+        processed += frames.size();
+    }
+    double elapsed_s =
+        chrono::duration<double>(chrono::steady_clock::now() - bench_start).count();
+
+    cout << "{" << endl;
+    cout << "  \"video\": \"" << video << "\"," << endl;
+    cout << "  \"batch\": " << batch << "," << endl;
+    cout << "  \"warmup_frames\": " << warmup_frames << "," << endl;
+    cout << "  \"frames\": " << processed << "," << endl;
+    cout << "  \"sustained_fps\": " << (elapsed_s > 0 ? processed / elapsed_s : 0) << "," << endl;
+    cout << "  \"stages\": {" << endl;
+    print_stage_json("decode", decode_samples);
+    print_stage_json("preprocess", preprocess_samples);
+    print_stage_json("h2d", h2d_samples);
+    print_stage_json("forward", forward_samples);
+    print_stage_json("postprocess", postprocess_samples);
+    print_stage_json("total", total_samples, true);
+    cout << "  }" << endl;
+    cout << "}" << endl;
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include "capture_source.hpp"
+
+#include <iostream>
+#include <vector>
+#include "opencv2/imgproc.hpp"
+#include "opencv2/videoio.hpp"
+
+#if __linux__
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+#include <cstring>
+#endif
+
+using namespace std;
+using namespace cv;
+
+namespace
+{
+
+// cv::VideoCapture fallback for files/URLs, and the carrier for explicit
+// GStreamer pipelines (OpenCV's CAP_GSTREAMER keeps NVDEC output in the
+// decoder chain until the appsink hand-off).
+class OpenCvCapture : public CaptureSource
+{
+public:
+    OpenCvCapture(const string &uri, int api) : cap_(uri, api) {}
+
+    bool read(Mat &frame) override
+    {
+        return cap_.read(frame);
+    }
+
+    bool isOpened() const override
+    {
+        return cap_.isOpened();
+    }
+
+private:
+    VideoCapture cap_;
+};
+
+#if __linux__
+
+// Live camera through V4L2 with mmap'd buffers. The driver DMAs straight
+// into the mapped kernel buffers; read() converts YUYV->BGR once, from
+// the mapped memory into the caller's Mat, and requeues the buffer.
+class V4l2Capture : public CaptureSource
+{
+public:
+    explicit V4l2Capture(const string &device)
+    {
+        fd_ = ::open(device.c_str(), O_RDWR);
+        if (fd_ < 0)
+        {
+            cerr << "v4l2: cannot open " << device << endl;
+            return;
+        }
+
+        v4l2_format fmt;
+        memset(&fmt, 0, sizeof(fmt));
+        fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        fmt.fmt.pix.width = 1280;
+        fmt.fmt.pix.height = 720;
+        fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+        fmt.fmt.pix.field = V4L2_FIELD_NONE;
+        if (ioctl(fd_, VIDIOC_S_FMT, &fmt) < 0)
+        {
+            cerr << "v4l2: VIDIOC_S_FMT failed" << endl;
+            return;
+        }
+        width_ = fmt.fmt.pix.width;
+        height_ = fmt.fmt.pix.height;
+
+        v4l2_requestbuffers req;
+        memset(&req, 0, sizeof(req));
+        req.count = kNumBuffers;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        if (ioctl(fd_, VIDIOC_REQBUFS, &req) < 0 || req.count < 2)
+        {
+            cerr << "v4l2: VIDIOC_REQBUFS failed" << endl;
+            return;
+        }
+
+        buffers_.resize(req.count);
+        for (unsigned i = 0; i < req.count; i++)
+        {
+            v4l2_buffer buf;
+            memset(&buf, 0, sizeof(buf));
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            buf.index = i;
+            if (ioctl(fd_, VIDIOC_QUERYBUF, &buf) < 0)
+            {
+                cerr << "v4l2: VIDIOC_QUERYBUF failed" << endl;
+                return;
+            }
+            buffers_[i].length = buf.length;
+            buffers_[i].start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE,
+                                     MAP_SHARED, fd_, buf.m.offset);
+            if (buffers_[i].start == MAP_FAILED)
+            {
+                cerr << "v4l2: mmap failed" << endl;
+                return;
+            }
+            if (ioctl(fd_, VIDIOC_QBUF, &buf) < 0)
+            {
+                cerr << "v4l2: VIDIOC_QBUF failed" << endl;
+                return;
+            }
+        }
+
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (ioctl(fd_, VIDIOC_STREAMON, &type) < 0)
+        {
+            cerr << "v4l2: VIDIOC_STREAMON failed" << endl;
+            return;
+        }
+        streaming_ = true;
+    }
+
+    ~V4l2Capture() override
+    {
+        if (streaming_)
+        {
+            v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            ioctl(fd_, VIDIOC_STREAMOFF, &type);
+        }
+        for (auto &b : buffers_)
+        {
+            if (b.start && b.start != MAP_FAILED)
+                munmap(b.start, b.length);
+        }
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    bool read(Mat &frame) override
+    {
+        if (!streaming_)
+            return false;
+
+        v4l2_buffer buf;
+        memset(&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        if (ioctl(fd_, VIDIOC_DQBUF, &buf) < 0)
+            return false;
+
+        // Wrap the mapped buffer in place; the only copy is the color
+        // conversion into the output Mat.
+        Mat yuyv(height_, width_, CV_8UC2, buffers_[buf.index].start);
+        cvtColor(yuyv, frame, COLOR_YUV2BGR_YUY2);
+
+        ioctl(fd_, VIDIOC_QBUF, &buf);
+        return true;
+    }
+
+    bool isOpened() const override
+    {
+        return streaming_;
+    }
+
+private:
+    static const unsigned kNumBuffers = 4;
+
+    struct MappedBuffer
+    {
+        void *start = nullptr;
+        size_t length = 0;
+    };
+
+    int fd_ = -1;
+    int width_ = 0;
+    int height_ = 0;
+    bool streaming_ = false;
+    vector<MappedBuffer> buffers_;
+};
+
+#endif // __linux__
+
+} // namespace
+
+unique_ptr<CaptureSource> CaptureSource::open(const string &uri)
+{
+#if __linux__
+    if (uri.compare(0, 7, "v4l2://") == 0)
+    {
+        return unique_ptr<CaptureSource>(new V4l2Capture(uri.substr(7)));
+    }
+#endif
+    if (uri.compare(0, 6, "gst://") == 0)
+    {
+        return unique_ptr<CaptureSource>(new OpenCvCapture(uri.substr(6), CAP_GSTREAMER));
+    }
+    return unique_ptr<CaptureSource>(new OpenCvCapture(uri, CAP_ANY));
+}
@@ -0,0 +1,34 @@
+#ifndef CAPTURE_SOURCE_HPP
+#define CAPTURE_SOURCE_HPP
+
+#include <memory>
+#include <string>
+#include "opencv2/core.hpp"
+
+// Capture abstraction for the decode stage. Backends:
+//
+//   v4l2:///dev/video0   - live camera through V4L2 mmap'd buffers; the
+//                          driver DMAs into kernel buffers mapped into our
+//                          address space, and the only CPU pixel touch is
+//                          the single YUYV->BGR conversion into the output
+//                          Mat (cv::VideoCapture does two extra memcpys on
+//                          top of that).
+//   gst://<pipeline>     - explicit GStreamer pipeline, e.g. an NVDEC/
+//                          nvv4l2decoder chain on Jetson, ending in an
+//                          appsink OpenCV can pull from.
+//   anything else        - cv::VideoCapture file/URL fallback.
+class CaptureSource
+{
+public:
+    virtual ~CaptureSource() {}
+
+    // Fills the next frame as 8UC3 BGR. Returns false at end of stream or
+    // on device error.
+    virtual bool read(cv::Mat &frame) = 0;
+
+    virtual bool isOpened() const = 0;
+
+    static std::unique_ptr<CaptureSource> open(const std::string &uri);
+};
+
+#endif // CAPTURE_SOURCE_HPP
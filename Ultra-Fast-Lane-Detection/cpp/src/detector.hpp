@@ -0,0 +1,92 @@
+#ifndef DETECTOR_HPP
+#define DETECTOR_HPP
+
+#include <memory>
+#include <vector>
+#include "opencv2/core.hpp"
+#include "lane_constants.hpp"
+
+// Model configuration; switch to TuSimpleConfig for the TuSimple export.
+using LaneCfg = CuLaneConfig;
+
+// Depth of the inter-stage pipeline queues.
+extern int pipeline_queue_depth;
+
+// Wall-clock cost of one RunLaneDetectionBatch call split by stage, in
+// milliseconds. Filled only when a pointer is passed in: per-stage timing
+// needs stream synchronization at stage boundaries, which the production
+// path must not pay. Used by the headless benchmark.
+struct StageTimings
+{
+    double preprocess_ms = 0;   // staging copy + device-side resize/convert
+    double h2d_ms = 0;          // pinned-memory uploads
+    double forward_ms = 0;      // backbone forward pass
+    double postprocess_ms = 0;  // GPU postprocess + D2H copy + drawing
+};
+
+// Lane estimate for one frame: pixel points indexed [lane][point], with
+// y fixed to the (scaled) row anchors.
+typedef std::vector<std::vector<cv::Point2f> > LanePoints;
+
+// The detection core: owns the model, the inference stream and the
+// pinned staging buffers, so it can be embedded in processes other than
+// the video pipeline (the safety supervisor links it for on-demand
+// single-frame queries). The implementation lives behind an opaque
+// pointer to keep libtorch out of this header.
+class LaneDetector
+{
+public:
+    LaneDetector();
+    ~LaneDetector();
+
+    // Selects the inference backend (UFLD_BACKEND=tensorrt when built
+    // with USE_TENSORRT), loads the model and uploads the grid
+    // constants. Must be called once before detection or warmup.
+    void Init();
+
+    // Pre-runs the model on synthetic frames so cuDNN autotuning, CUDA
+    // allocator growth and stream setup are all paid at startup. Without
+    // it the first real frame costs ~900 ms against a 25 ms steady
+    // state — exactly the cliff a cold-started caller with a deadline
+    // would hit. Pass the batch size the caller will use, since cuDNN
+    // tunes per input shape.
+    void Warmup(int batch_size = 1);
+
+    // Batched detection: stacks N camera frames into one {N,3,288,800}
+    // input, runs a single forward pass, and demultiplexes lane points
+    // per frame.
+    std::vector<LanePoints> DetectPointsBatch(const std::vector<cv::Mat> &frames,
+                                              StageTimings *timings = nullptr);
+
+    // Single-frame low-latency query: a batch of one.
+    LanePoints DetectPoints(const cv::Mat &frame);
+
+    // Process-wide instance used by the free-function entry points.
+    static LaneDetector &Shared();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Free-function entry points kept for the video pipeline and the
+// benchmark; they forward to LaneDetector::Shared().
+void InitDetector();
+
+// Batched entry point: stacks N camera frames into one {N,3,288,800}
+// input, runs a single forward pass, and demultiplexes lane points per
+// frame.
+std::vector<LanePoints> RunLaneDetectionPointsBatch(const std::vector<cv::Mat> &frames,
+                                                    StageTimings *timings = nullptr);
+
+// Overlay a lane estimate onto its frame.
+void DrawLanePoints(cv::Mat &frame, const LanePoints &lanes);
+
+// Detect-and-draw wrappers kept for the video pipeline.
+std::vector<cv::Mat> RunLaneDetectionBatch(std::vector<cv::Mat> frames,
+                                           StageTimings *timings = nullptr);
+
+// Single-frame convenience wrapper: a batch of one.
+cv::Mat RunLaneDetection(cv::Mat frame);
+
+#endif // DETECTOR_HPP
@@ -0,0 +1,61 @@
+#ifndef FRAME_POOL_HPP
+#define FRAME_POOL_HPP
+
+#include <vector>
+#include "opencv2/core.hpp"
+#include <torch/torch.h>
+
+// Preallocated staging buffers for the frame upload path. The staging Mat
+// aliases a CUDA pinned host tensor, so the raw camera frame is copied
+// straight into page-locked memory and the H2D copy can run
+// asynchronously instead of going through a pageable bounce buffer. All
+// pixel conversion happens on the device after upload.
+struct FrameBuffers
+{
+    torch::Tensor pinned;  // {1, H, W, 3} uint8, pinned host memory
+    cv::Mat staging;       // CV_8UC3 view over pinned
+
+    // (Re)allocate for the incoming frame geometry; camera sources keep a
+    // fixed size so this runs once per buffer in practice.
+    void ensure(int width, int height)
+    {
+        if (!staging.empty() && staging.cols == width && staging.rows == height)
+            return;
+        pinned = torch::empty({1, height, width, 3},
+                              torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(true));
+        staging = cv::Mat(height, width, CV_8UC3, pinned.data_ptr<uint8_t>());
+    }
+
+    // Async H2D copy of the raw frame; safe because the source is pinned
+    // and the buffer is not reused until the pool cycles back around.
+    torch::Tensor upload()
+    {
+        return pinned.to(torch::kCUDA, /*non_blocking=*/true);
+    }
+};
+
+// Fixed-size pool cycled round-robin by the inference stage. Sized one
+// deeper than the pipeline queues so a buffer is never rewritten while
+// its upload is still in flight.
+class FramePool
+{
+public:
+    explicit FramePool(size_t count)
+        : next_(0)
+    {
+        buffers_.resize(count);
+    }
+
+    FrameBuffers &acquire()
+    {
+        FrameBuffers &buf = buffers_[next_];
+        next_ = (next_ + 1) % buffers_.size();
+        return buf;
+    }
+
+private:
+    std::vector<FrameBuffers> buffers_;
+    size_t next_;
+};
+
+#endif // FRAME_POOL_HPP
@@ -0,0 +1,95 @@
+#ifndef LANE_CONSTANTS_HPP
+#define LANE_CONSTANTS_HPP
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+// Compile-time lookup tables for the UFLD grid geometry. These were
+// previously rebuilt on the heap for every frame (linspace, arrange and
+// the row-anchor array); all of them are constants of the model
+// configuration, so they are computed at compile time and templated on
+// the griding/anchor counts so the TuSimple configuration works too.
+//
+// The tables are built by index-sequence pack expansion rather than by
+// writing through array elements: std::array::operator[] is not
+// constexpr until C++17 and the targets build as C++14.
+
+namespace lane_tables
+{
+
+template <size_t Num, size_t... Is>
+constexpr std::array<double, Num> linspace_impl(double start, double delta, double end,
+                                                std::index_sequence<Is...>)
+{
+    // the last element is pinned to `end` so the endpoints stay exact
+    return {{(Is + 1 == Num ? end : start + delta * Is)...}};
+}
+
+template <size_t... Is>
+constexpr std::array<int, sizeof...(Is)> arrange_impl(std::index_sequence<Is...>)
+{
+    return {{static_cast<int>(Is)...}};
+}
+
+template <size_t... Is>
+constexpr std::array<int, sizeof...(Is)> range_impl(int start, int step,
+                                                    std::index_sequence<Is...>)
+{
+    return {{(start + step * static_cast<int>(Is))...}};
+}
+
+}  // namespace lane_tables
+
+template <size_t Num>
+constexpr std::array<double, Num> make_linspace(double start, double end)
+{
+    return lane_tables::linspace_impl<Num>(start,
+                                           Num > 1 ? (end - start) / (Num - 1) : 0.0,
+                                           Num > 1 ? end : start,
+                                           std::make_index_sequence<Num>{});
+}
+
+template <size_t Num>
+constexpr std::array<int, Num> make_arrange()
+{
+    return lane_tables::arrange_impl(std::make_index_sequence<Num>{});
+}
+
+template <size_t Num>
+constexpr std::array<int, Num> make_range(int start, int step)
+{
+    return lane_tables::range_impl(start, step, std::make_index_sequence<Num>{});
+}
+
+// row_anchor() is a constexpr function rather than a static data member
+// so the header stays ODR-clean under C++14 when included from several
+// translation units.
+struct CuLaneConfig
+{
+    static constexpr int griding_num = 200;
+    static constexpr int num_anchors = 18;
+    static constexpr int num_lanes = 4;
+    static constexpr int input_width = 800;
+    static constexpr int input_height = 288;
+    static constexpr std::array<int, num_anchors> row_anchor()
+    {
+        return {121, 131, 141, 150, 160, 170, 180, 189, 199,
+                209, 219, 228, 238, 248, 258, 267, 277, 287};
+    }
+};
+
+struct TuSimpleConfig
+{
+    static constexpr int griding_num = 100;
+    static constexpr int num_anchors = 56;
+    static constexpr int num_lanes = 4;
+    static constexpr int input_width = 800;
+    static constexpr int input_height = 288;
+    static constexpr std::array<int, num_anchors> row_anchor()
+    {
+        return make_range<num_anchors>(64, 4);
+    }
+};
+
+#endif // LANE_CONSTANTS_HPP
@@ -0,0 +1,99 @@
+#ifndef LANE_TRACKER_HPP
+#define LANE_TRACKER_HPP
+
+#include <vector>
+#include "opencv2/core.hpp"
+#include "detector.hpp"
+
+// Temporal lane tracker: runs the network only every Nth frame and
+// propagates the last estimate with a constant-velocity predictor in
+// between. The camera delivers 60 fps but the model sustains ~25, so
+// this keeps the published estimate updating at full camera rate while
+// GPU load drops by the inference interval.
+//
+// UFLD y-coordinates are pinned to the row anchors, so only x moves;
+// per-lane per-row x velocity is estimated from the two most recent
+// detections. When the lane structure changes between detections
+// (different lane or point counts) velocities reset to zero rather than
+// matching stale geometry.
+class LaneTracker
+{
+public:
+    explicit LaneTracker(int inference_interval = 2)
+        : interval_(inference_interval < 1 ? 1 : inference_interval), frame_idx_(0)
+    {
+    }
+
+    // Returns the lane estimate for this frame: a fresh detection on
+    // every Nth frame, a propagated one otherwise.
+    LanePoints track(const cv::Mat &frame)
+    {
+        if (frame_idx_++ % interval_ == 0)
+        {
+            LanePoints detected = RunLaneDetectionPointsBatch({frame})[0];
+            updateVelocity(detected);
+            last_ = detected;
+            predicted_ = detected;
+        }
+        else
+        {
+            propagate();
+        }
+        return predicted_;
+    }
+
+private:
+    bool sameShape(const LanePoints &a, const LanePoints &b) const
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].size() != b[i].size())
+                return false;
+        }
+        return true;
+    }
+
+    void updateVelocity(const LanePoints &detected)
+    {
+        velocity_.assign(detected.size(), std::vector<float>());
+        for (size_t i = 0; i < detected.size(); i++)
+        {
+            velocity_[i].assign(detected[i].size(), 0.0f);
+        }
+        if (!sameShape(detected, last_))
+            return;
+        // Per-frame velocity: the last two detections are one interval
+        // apart.
+        for (size_t i = 0; i < detected.size(); i++)
+        {
+            for (size_t k = 0; k < detected[i].size(); k++)
+            {
+                velocity_[i][k] = (detected[i][k].x - last_[i][k].x) / interval_;
+            }
+        }
+    }
+
+    void propagate()
+    {
+        for (size_t i = 0; i < predicted_.size(); i++)
+        {
+            for (size_t k = 0; k < predicted_[i].size(); k++)
+            {
+                if (i < velocity_.size() && k < velocity_[i].size())
+                {
+                    predicted_[i][k].x += velocity_[i][k];
+                }
+            }
+        }
+    }
+
+    int interval_;
+    long frame_idx_;
+    LanePoints last_;
+    LanePoints predicted_;
+    std::vector<std::vector<float> > velocity_;
+};
+
+#endif // LANE_TRACKER_HPP
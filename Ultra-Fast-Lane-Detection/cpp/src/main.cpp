@@ -1,183 +1,173 @@
 #include <iostream>
-#include <memory>
+#include <thread>
 #include <chrono>
+#include <cmath>
 #include "opencv2/core.hpp"
-#include "opencv2/imgproc.hpp"
 #include "opencv2/highgui.hpp"
 #include "opencv2/videoio.hpp"
-#include <torch/script.h>
-#include <vector>
+#include "detector.hpp"
+#include "spsc_queue.hpp"
+#include "capture_source.hpp"
+#include "lane_tracker.hpp"
+#include "trace.hpp"
+#include "telemetry_bus.hpp"
 
 using namespace std;
 using namespace cv;
-using namespace torch::indexing;
 
-torch::jit::script::Module module_;
+// Lane boundary closer to the image centre than this warns; tuned for
+// the 1280-wide camera where our lane occupies roughly the middle third.
+const float kDepartureThresholdPx = 120.0f;
 
-std::vector<double> linspace(double start_in, double end_in, int num_in)
+// Publishes one record per processed frame onto the shared-memory bus
+// (telemetry_bus.hpp) the ADAS display listens on. Departure heuristic:
+// take each lane's closest point (largest y) and warn when the nearest
+// boundary sits within the threshold of the image centre.
+static void PublishLaneTelemetry(telemetry::Publisher &publisher,
+                                 const LanePoints &lanes, int img_w, unsigned frame_id)
 {
-    std::vector<double> linspaced;
-
-    double start = static_cast<double>(start_in);
-    double end = static_cast<double>(end_in);
-    double num = static_cast<double>(num_in);
-
-    if (num == 0) { return linspaced; }
-    if (num == 1) 
-    {
-        linspaced.push_back(start);
-        return linspaced;
-    }
-
-    double delta = (end - start) / (num - 1);
-
-    for(int i=0; i < num-1; ++i)
+    if (!publisher.is_open())
+        return;
+
+    float centre = img_w / 2.0f;
+    float nearest_offset = 0;
+    bool have_lane = false;
+    unsigned lane_count = 0;
+    for (size_t i = 0; i < lanes.size(); i++)
     {
-      linspaced.push_back(start + delta * i);
+        if (lanes[i].empty())
+            continue;
+        lane_count++;
+        Point2f low = lanes[i][0];
+        for (size_t k = 1; k < lanes[i].size(); k++)
+        {
+            if (lanes[i][k].y > low.y)
+                low = lanes[i][k];
+        }
+        float offset = low.x - centre;
+        if (!have_lane || fabs(offset) < fabs(nearest_offset))
+        {
+            nearest_offset = offset;
+            have_lane = true;
+        }
     }
-    linspaced.push_back(end); // I want to ensure that start and end
-                            // are exactly the same as the input
 
-    return linspaced;
+    telemetry::Record record;
+    record.frame_id = frame_id;
+    record.lane_count = lane_count;
+    record.lane_offset_px = have_lane ? nearest_offset : 0;
+    record.departure = have_lane && fabs(nearest_offset) < kDepartureThresholdPx ? 1 : 0;
+    record.timestamp_us = chrono::duration_cast<chrono::microseconds>(
+                              chrono::steady_clock::now().time_since_epoch())
+                              .count();
+    publisher.publish(record);
 }
 
-std::vector<int> arrange(int num)
+void RunVideo()
 {
-    std::vector<int> result;
-    for (int i = 0; i < num; i++)
+    // UFLD_SOURCE selects the capture backend: v4l2:///dev/videoN for a
+    // live camera through mmap'd buffers, gst://<pipeline> for an
+    // NVDEC/GStreamer chain, anything else falls back to cv::VideoCapture.
+    const char *source = getenv("UFLD_SOURCE");
+    auto cap = CaptureSource::open(source ? source : "/data/video/dout.mp4");
+		cout << "Prepare to load";
+
+    if (!cap->isOpened())
     {
-        result.push_back(i);
+        cerr << "failed to open capture source" << endl;
+        return;
     }
-    return result;
-}
 
-int counter = 0;
-Mat RunLaneDetection(Mat frame)
-{
+    // Three-stage pipeline: decode -> inference -> render. Each stage runs
+    // on its own thread so the GPU no longer idles during video decode and
+    // capture no longer stalls behind the forward pass.
+    SpscQueue<Mat> decode_queue(pipeline_queue_depth);
+    SpscQueue<Mat> render_queue(pipeline_queue_depth);
 
-    int img_w = 1280;
-    int img_h = 720; 
-    
-    Mat dest;
-    // CV Resize
-    cv::resize(frame, dest, cv::Size(800, 288));
-    cv::cvtColor(dest, dest, cv::COLOR_BGR2RGB);  // BGR -> RGB
-    dest.convertTo(dest, CV_32FC3, 1.0f / 255.0f);  // normalization 1/255
-    int culane_row_anchor[] = {121, 131, 141, 150, 160, 170, 180, 189, 199, 209, 219, 228, 238, 248, 258, 267, 277, 287};
-
-
-    auto tensor_img = torch::from_blob(dest.data, {1, dest.rows, dest.cols, dest.channels()}).to(torch::kCUDA);
-
-
-
-    tensor_img = tensor_img.permute({0, 3, 1, 2}).contiguous();  // BHWC -> BCHW (Batch, Channel, Height, Width)
-
-    tensor_img = tensor_img.to(torch::kHalf);
-    std::vector<torch::jit::IValue> inputs;
-    inputs.emplace_back(tensor_img);
-    torch::jit::IValue output = module_.forward(inputs);
-    torch::Tensor outputTensor = output.toTensor();
-   
-    // Logic
-    int cuLaneGriding_num = 200;
-    std::vector<double> linSpaceVector = linspace(0, 800 - 1, cuLaneGriding_num);
-    double linSpace = linSpaceVector[1] - linSpaceVector[0];
-    // Remove 1
-    outputTensor = outputTensor.squeeze(0);
-    // Flip
-    outputTensor = outputTensor.flip(1);
-
-
-    // Calculate SoftMax
-    torch::Tensor prob = outputTensor.index({Slice(None, -1)}).softmax(0);
-
-    // Calculate idx
-    std::vector<int> idx = arrange(cuLaneGriding_num + 1);  
-    auto arrange_idx = torch::from_blob(idx.data(), {cuLaneGriding_num, 1, 1}).to(torch::kCUDA);
-    outputTensor = outputTensor.argmax(0);
-		
-
-
-    auto mult = prob * arrange_idx;
-
-    auto loc = mult.sum(1);
-    for (int i = 0; i < outputTensor.size(0); i++)
-    {  
-   			if (outputTensor[i][0].item<long>() == cuLaneGriding_num)
-				{
-					outputTensor[i][0] = 0;
-				}	
-   			if (outputTensor[i][1].item<long>() == cuLaneGriding_num)
-				{
-					outputTensor[i][1] = 0;
-				}	
-   			if (outputTensor[i][2].item<long>() == cuLaneGriding_num)
-				{
-					outputTensor[i][2] = 0;
-				}	     
-   			if (outputTensor[i][3].item<long>() == cuLaneGriding_num)
-				{
-					outputTensor[i][3] = 0;
-				}	
-    }
-		torch::Tensor res = outputTensor;
-   
-    for (int i = 0; i < outputTensor.size(1); i++)
+    std::thread decode_thread([&]()
     {
-        for (int k = 0; k < outputTensor.size(0); k++)
+        Mat frame;
+        while (true)
         {
-            if (outputTensor[k][i].item<long>() > 0)
-            {
-
-    
-                long widht = outputTensor[k][i].item<long>()  * linSpace * img_w /800;
-                long height = img_h * (float(culane_row_anchor[18-1-k])/288);
-								
-								if (counter == 0)
-								{
-									cout << widht << ' ' << height;
-								  cout << '\n';
-								}
-
-  
-                circle( frame, Point( widht, height ), 5, Scalar( 0, 255, 0 ), -1);
-            }
+            trace::Scope scope("decode");
+            if (!cap->read(frame)) // read a new frame from the source
+                break;
+            if (!decode_queue.push(frame.clone()))
+                break;
         }
-    }
-		counter = counter + 1;
+        decode_queue.close();
+    });
 
-    
+    // UFLD_TRACK_INTERVAL=N runs the network on every Nth frame only and
+    // propagates lane points with a constant-velocity predictor in
+    // between, so the overlay still updates at full camera rate.
+    const char *track_env = getenv("UFLD_TRACK_INTERVAL");
+    int track_interval = track_env ? atoi(track_env) : 1;
 
-    return frame;
-}
+    std::thread inference_thread([&]()
+    {
+        LaneTracker tracker(track_interval);
+
+        // Every processed frame is published to the display over shared
+        // memory; the display side drives its LDW warning from this
+        // instead of the old simulated data.
+        telemetry::Publisher publisher;
+        if (!publisher.open())
+            cerr << "telemetry bus unavailable, running without the display link" << endl;
+
+        unsigned frame_id = 0;
+        Mat frame;
+        while (decode_queue.pop(frame))
+        {
+            trace::Scope scope("inference");
+            LanePoints lanes;
+            if (track_interval > 1)
+                lanes = tracker.track(frame);
+            else
+                lanes = RunLaneDetectionPointsBatch({frame})[0];
+            PublishLaneTelemetry(publisher, lanes, frame.cols, frame_id++);
+            DrawLanePoints(frame, lanes);
+            if (!render_queue.push(frame))
+                break;
+        }
+        render_queue.close();
+    });
 
-void RunVideo()
-{
-    VideoCapture cap("/data/video/dout.mp4"); 
-		cout << "Prepare to load";
-    
-    Mat frame;
-    while (true)
+    // Render stays on the calling thread: imshow/waitKey must run where
+    // the HighGUI event loop lives.
+    Mat result;
+    while (render_queue.pop(result))
     {
-        cap.read(frame); // read a new frame from video 
-        cv::imshow("", RunLaneDetection(frame));
+        {
+            trace::Scope scope("render");
+            cv::imshow("", result);
+        }
 
-        if (waitKey(10) >= 0)
+        // a SIGUSR1 received since the last frame flushes the trace here
+        trace::poll();
+
+        if (waitKey(1) >= 0)
             break;
     }
+
+    // Unblock the upstream stages in case we quit before end of stream.
+    decode_queue.close();
+    render_queue.close();
+    decode_thread.join();
+    inference_thread.join();
 }
 
 int main() {
-    // Load JIT
-    module_ = torch::jit::load("/data/Models/UltraFastLaneDetection/UFLD.torchscript.pt");
-    module_.to(torch::kCUDA);
-    module_.to(torch::kHalf);
-    module_.eval();
-
-    // check if gpu flag is set
-    bool is_gpu = true;
+    // UFLD_TRACE=<path> captures Chrome trace-event JSON of every
+    // pipeline stage; SIGUSR1 dumps mid-run, shutdown dumps once more.
+    trace::init();
+    InitDetector();
+    // Pay cuDNN autotuning and allocator growth before the pipeline
+    // starts, so the first displayed frame is not ~900 ms late.
+    LaneDetector::Shared().Warmup();
 
     RunVideo();
+    trace::dump();
     cv::destroyAllWindows();
     return 0;
 }
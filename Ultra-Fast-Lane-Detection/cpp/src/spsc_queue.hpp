@@ -0,0 +1,72 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Bounded single-producer/single-consumer queue used to connect the
+// capture -> inference -> render stages. Lock-free: one writer thread
+// calls push(), one reader thread calls pop(). A full queue blocks the
+// producer (backpressure) instead of dropping or growing.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t depth)
+        : buffer_(depth + 1), head_(0), tail_(0), closed_(false)
+    {
+    }
+
+    // Blocks while the queue is full. Returns false once close() was called.
+    bool push(T item)
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t next = increment(tail);
+        while (next == head_.load(std::memory_order_acquire))
+        {
+            if (closed_.load(std::memory_order_relaxed))
+                return false;
+            std::this_thread::yield();
+        }
+        if (closed_.load(std::memory_order_relaxed))
+            return false;
+        buffer_[tail] = std::move(item);
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Blocks while the queue is empty. Returns false once the queue is
+    // closed and fully drained.
+    bool pop(T &item)
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        while (head == tail_.load(std::memory_order_acquire))
+        {
+            if (closed_.load(std::memory_order_relaxed))
+                return false;
+            std::this_thread::yield();
+        }
+        item = std::move(buffer_[head]);
+        head_.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+    void close()
+    {
+        closed_.store(true, std::memory_order_relaxed);
+    }
+
+private:
+    size_t increment(size_t idx) const
+    {
+        return (idx + 1) % buffer_.size();
+    }
+
+    std::vector<T> buffer_;
+    std::atomic<size_t> head_;  // consumer index
+    std::atomic<size_t> tail_;  // producer index
+    std::atomic<bool> closed_;
+};
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,170 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Always-on, low-overhead tracing for the vehicle pipeline. Scoped
+// events land in a fixed ring buffer (a relaxed fetch_add plus a struct
+// store per event, no locks, no allocation), and the buffer is dumped as
+// Chrome trace-event JSON that Perfetto / chrome://tracing open
+// directly. Enabled by setting UFLD_TRACE to the output path; SIGUSR1
+// requests a dump from a running process, and the pipeline flushes once
+// more on shutdown. When UFLD_TRACE is unset every scope is a single
+// branch.
+namespace trace
+{
+
+struct Event
+{
+    const char *name;  // must be a string literal; the dump reads it later
+    double ts_us;      // start, microseconds since init()
+    double dur_us;
+    unsigned tid;
+};
+
+// Ring capacity; at ~10 events per frame this holds several minutes.
+const size_t kCapacity = 1 << 15;
+
+inline bool &enabled()
+{
+    static bool on = false;
+    return on;
+}
+
+inline std::string &output_path()
+{
+    static std::string path;
+    return path;
+}
+
+inline Event *buffer()
+{
+    static Event events[kCapacity];
+    return events;
+}
+
+inline std::atomic<unsigned long> &write_index()
+{
+    static std::atomic<unsigned long> index(0);
+    return index;
+}
+
+inline std::atomic<bool> &dump_requested()
+{
+    static std::atomic<bool> requested(false);
+    return requested;
+}
+
+inline std::chrono::steady_clock::time_point epoch()
+{
+    static std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+inline double now_us()
+{
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - epoch())
+        .count();
+}
+
+// Small dense thread ids instead of raw pthread handles, so the trace
+// rows read decode/inference/render rather than 140123456789.
+inline unsigned current_tid()
+{
+    static std::atomic<unsigned> next_tid(0);
+    static thread_local unsigned tid = next_tid.fetch_add(1);
+    return tid;
+}
+
+inline void record(const char *name, double ts_us, double dur_us)
+{
+    unsigned long n = write_index().fetch_add(1, std::memory_order_relaxed);
+    Event &e = buffer()[n % kCapacity];
+    e.name = name;
+    e.ts_us = ts_us;
+    e.dur_us = dur_us;
+    e.tid = current_tid();
+}
+
+// Writes the ring as Chrome trace-event JSON. Not called from the signal
+// handler; the handler only raises a flag that poll() acts on from a
+// pipeline thread.
+inline void dump()
+{
+    if (!enabled())
+        return;
+    FILE *f = fopen(output_path().c_str(), "w");
+    if (!f)
+    {
+        fprintf(stderr, "trace: cannot write %s\n", output_path().c_str());
+        return;
+    }
+    unsigned long written = write_index().load(std::memory_order_relaxed);
+    unsigned long count = written < kCapacity ? written : kCapacity;
+    fprintf(f, "{\"traceEvents\":[\n");
+    for (unsigned long n = 0; n < count; n++)
+    {
+        const Event &e = buffer()[n];
+        fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                n ? ",\n" : "", e.name, e.tid, e.ts_us, e.dur_us);
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    fprintf(stderr, "trace: %lu events written to %s\n", count, output_path().c_str());
+}
+
+// Checked once per rendered frame; dumps when SIGUSR1 asked for it.
+inline void poll()
+{
+    if (dump_requested().exchange(false, std::memory_order_relaxed))
+        dump();
+}
+
+inline void signal_handler(int)
+{
+    dump_requested().store(true, std::memory_order_relaxed);
+}
+
+// Reads UFLD_TRACE (output path) and arms SIGUSR1. Call once at startup,
+// before the pipeline threads exist.
+inline void init()
+{
+    const char *path = getenv("UFLD_TRACE");
+    if (!path || !*path)
+        return;
+    output_path() = path;
+    epoch();  // pin t=0 here
+    enabled() = true;
+    signal(SIGUSR1, signal_handler);
+}
+
+// RAII span: records [construction, destruction) under the given
+// literal. Free when tracing is off.
+class Scope
+{
+public:
+    explicit Scope(const char *name)
+        : name_(name), start_us_(enabled() ? now_us() : 0)
+    {
+    }
+
+    ~Scope()
+    {
+        if (enabled())
+            record(name_, start_us_, now_us() - start_us_);
+    }
+
+private:
+    const char *name_;
+    double start_us_;
+};
+
+}  // namespace trace
+
+#endif  // TRACE_HPP
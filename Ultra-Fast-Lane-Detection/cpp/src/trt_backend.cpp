@@ -0,0 +1,186 @@
+#ifdef USE_TENSORRT
+
+#include "trt_backend.hpp"
+#include <NvOnnxParser.h>
+#include <c10/cuda/CUDAStream.h>
+#include <cuda_runtime_api.h>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+
+class TrtLogger : public nvinfer1::ILogger
+{
+    void log(Severity severity, const char *msg) noexcept override
+    {
+        if (severity <= Severity::kWARNING)
+            cerr << "[TensorRT] " << msg << endl;
+    }
+};
+
+TrtLogger trt_logger;
+
+// The engine decides the binding I/O types; we only speak these two.
+bool bindingDtype(nvinfer1::DataType trt_type, torch::ScalarType &torch_type)
+{
+    switch (trt_type)
+    {
+    case nvinfer1::DataType::kFLOAT:
+        torch_type = torch::kFloat32;
+        return true;
+    case nvinfer1::DataType::kHALF:
+        torch_type = torch::kHalf;
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+string TrtBackend::planPath(const string &cache_dir, bool fp16) const
+{
+    // Plans are not portable across GPUs or precisions, so both go into
+    // the cache key.
+    cudaDeviceProp prop;
+    cudaGetDeviceProperties(&prop, 0);
+    string gpu = prop.name;
+    for (char &c : gpu)
+    {
+        if (c == ' ' || c == '/')
+            c = '-';
+    }
+    return cache_dir + "/UFLD." + gpu + (fp16 ? ".fp16" : ".fp32") + ".plan";
+}
+
+bool TrtBackend::loadPlan(const string &plan_file)
+{
+    ifstream ifs(plan_file, ios::binary | ios::ate);
+    if (ifs.fail())
+        return false;
+    streamsize size = ifs.tellg();
+    ifs.seekg(0, ios::beg);
+    vector<char> plan(size);
+    if (!ifs.read(plan.data(), size))
+        return false;
+    engine_.reset(runtime_->deserializeCudaEngine(plan.data(), plan.size()));
+    if (engine_)
+        cout << "TensorRT: loaded cached engine " << plan_file << endl;
+    return engine_ != nullptr;
+}
+
+bool TrtBackend::buildFromOnnx(const string &onnx_path, const string &plan_file, bool fp16)
+{
+    cout << "TensorRT: building engine from " << onnx_path << " (one-time cost)" << endl;
+    unique_ptr<nvinfer1::IBuilder> builder(nvinfer1::createInferBuilder(trt_logger));
+    if (!builder)
+        return false;
+    unique_ptr<nvinfer1::INetworkDefinition> network(builder->createNetworkV2(
+        1U << static_cast<uint32_t>(nvinfer1::NetworkDefinitionCreationFlag::kEXPLICIT_BATCH)));
+    unique_ptr<nvonnxparser::IParser> parser(nvonnxparser::createParser(*network, trt_logger));
+    if (!parser->parseFromFile(onnx_path.c_str(),
+                               static_cast<int>(nvinfer1::ILogger::Severity::kWARNING)))
+    {
+        cerr << "TensorRT: failed to parse " << onnx_path << endl;
+        return false;
+    }
+
+    unique_ptr<nvinfer1::IBuilderConfig> config(builder->createBuilderConfig());
+    config->setMemoryPoolLimit(nvinfer1::MemoryPoolType::kWORKSPACE, 1ULL << 30);
+    if (fp16 && builder->platformHasFastFp16())
+        config->setFlag(nvinfer1::BuilderFlag::kFP16);
+
+    unique_ptr<nvinfer1::IHostMemory> plan(builder->buildSerializedNetwork(*network, *config));
+    if (!plan)
+        return false;
+
+    ofstream ofs(plan_file, ios::binary);
+    if (ofs)
+    {
+        ofs.write(static_cast<const char *>(plan->data()), plan->size());
+        cout << "TensorRT: cached engine to " << plan_file << endl;
+    }
+    else
+    {
+        cerr << "TensorRT: could not write " << plan_file << ", engine will rebuild next run" << endl;
+    }
+
+    engine_.reset(runtime_->deserializeCudaEngine(plan->data(), plan->size()));
+    return engine_ != nullptr;
+}
+
+bool TrtBackend::init(const string &onnx_path, const string &cache_dir, bool fp16)
+{
+    runtime_.reset(nvinfer1::createInferRuntime(trt_logger));
+    if (!runtime_)
+        return false;
+
+    string plan_file = planPath(cache_dir, fp16);
+    if (!loadPlan(plan_file) && !buildFromOnnx(onnx_path, plan_file, fp16))
+        return false;
+
+    // kFP16 only changes internal precision, not the binding types:
+    // they stay whatever the ONNX export declares. Resolve them now and
+    // refuse anything forward() cannot feed, so a mismatch falls back to
+    // TorchScript instead of silently reinterpreting buffers.
+    if (!bindingDtype(engine_->getBindingDataType(0), input_dtype_) ||
+        !bindingDtype(engine_->getBindingDataType(1), output_dtype_))
+    {
+        cerr << "TensorRT: engine bindings are neither fp32 nor fp16" << endl;
+        return false;
+    }
+
+    context_.reset(engine_->createExecutionContext());
+    return context_ != nullptr;
+}
+
+torch::Tensor TrtBackend::forward(torch::Tensor input)
+{
+    input = input.to(input_dtype_).contiguous();
+
+    // The engine has fixed binding shapes baked in by the ONNX export.
+    // Feeding a different batch would silently run one frame and leave
+    // the callers reading past the end of a batch-1 output, so a
+    // mismatch fails loudly: re-export the model with the batch size the
+    // pipeline uses (see user-006's batch-4 mode and the ufld_bench
+    // batch argument).
+    nvinfer1::Dims in_dims = engine_->getBindingDimensions(0);
+    bool shape_ok = input.dim() == in_dims.nbDims;
+    for (int d = 0; shape_ok && d < in_dims.nbDims; d++)
+    {
+        shape_ok = input.size(d) == in_dims.d[d];
+    }
+    if (!shape_ok)
+    {
+        string want;
+        for (int d = 0; d < in_dims.nbDims; d++)
+        {
+            want += (d ? "x" : "") + to_string(in_dims.d[d]);
+        }
+        string got;
+        for (int64_t d = 0; d < input.dim(); d++)
+        {
+            got += (d ? "x" : "") + to_string(input.size(d));
+        }
+        throw std::runtime_error("TensorRT: input shape " + got + " does not match engine binding " +
+                                 want + "; re-export the ONNX model with this batch size");
+    }
+
+    nvinfer1::Dims out_dims = engine_->getBindingDimensions(1);
+    vector<int64_t> out_shape(out_dims.d, out_dims.d + out_dims.nbDims);
+    auto output = torch::empty(out_shape, input.options().dtype(output_dtype_));
+
+    void *bindings[2] = {input.data_ptr(), output.data_ptr()};
+    if (!context_->enqueueV2(bindings, at::cuda::getCurrentCUDAStream().stream(), nullptr))
+    {
+        throw std::runtime_error("TensorRT: enqueueV2 failed");
+    }
+    return output;
+}
+
+#endif // USE_TENSORRT
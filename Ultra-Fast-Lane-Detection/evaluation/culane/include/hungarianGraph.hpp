@@ -1,71 +1,124 @@
-﻿#ifndef HUNGARIAN_GRAPH_HPP
+#ifndef HUNGARIAN_GRAPH_HPP
 #define HUNGARIAN_GRAPH_HPP
 #include <vector>
+#include <cmath>
 using namespace std;
 
-struct pipartiteGraph {
-    vector<vector<double> > mat;
-    vector<bool> leftUsed, rightUsed;
-    vector<double> leftWeight, rightWeight;
-    vector<int>rightMatch, leftMatch;
-    int leftNum, rightNum;
-    bool matchDfs(int u) {
-        leftUsed[u] = true;
-        for (int v = 0; v < rightNum; v++) {
-            if (!rightUsed[v] && fabs(leftWeight[u] + rightWeight[v] - mat[u][v]) < 1e-2) {
-                rightUsed[v] = true;
-                if (rightMatch[v] == -1 || matchDfs(rightMatch[v])) {
-                    rightMatch[v] = u;
-                    leftMatch[u] = v;
-                    return true;
-                }
+// Maximum-weight assignment between annotation and detection lanes.
+//
+// Jonker-Volgenant style shortest-augmenting-path solver, O(n^3) with
+// dual potentials, replacing the old DFS Hungarian whose equality-graph
+// augmentation re-ran full used-flag resets inside a while(1) per vertex.
+// The cost matrix is flat row-major and every working array is owned by
+// the solver object, so a thread_local instance does zero allocations in
+// steady state once it has seen the largest lane count.
+struct AssignmentSolver {
+    // similarity is m x n with m <= n enforced by the caller via swap;
+    // leftMatch[i] = matched column or -1, rightMatch[j] = matched row or -1
+    void solve(const vector<vector<double> > &similarity, bool exchanged,
+               vector<int> &leftMatch, vector<int> &rightMatch) {
+        int m = exchanged ? (int)similarity[0].size() : (int)similarity.size();
+        int n = exchanged ? (int)similarity.size() : (int)similarity[0].size();
+
+        // pad to square; fake rows carry zero similarity and soak up the
+        // leftover columns
+        reserve(n);
+        double max_sim = 0;
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) {
+                double s = exchanged ? similarity[j][i] : similarity[i][j];
+                cost[i * n + j] = s;
+                if (s > max_sim) max_sim = s;
             }
         }
-        return false;
-    }
-    void resize(int leftNum, int rightNum) {
-        this->leftNum = leftNum;
-        this->rightNum = rightNum;
-        leftMatch.resize(leftNum);
-        rightMatch.resize(rightNum);
-        leftUsed.resize(leftNum);
-        rightUsed.resize(rightNum);
-        leftWeight.resize(leftNum);
-        rightWeight.resize(rightNum);
-        mat.resize(leftNum);
-        for (int i = 0; i < leftNum; i++) mat[i].resize(rightNum);
-    }
-    void match() {
-        for (int i = 0; i < leftNum; i++) leftMatch[i] = -1;
-        for (int i = 0; i < rightNum; i++) rightMatch[i] = -1;
-        for (int i = 0; i < rightNum; i++) rightWeight[i] = 0;
-        for (int i = 0; i < leftNum; i++) {
-            leftWeight[i] = -1e5;
-            for (int j = 0; j < rightNum; j++) {
-                if (leftWeight[i] < mat[i][j]) leftWeight[i] = mat[i][j];
+        // maximization -> minimization
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) {
+                cost[i * n + j] = max_sim - cost[i * n + j];
             }
         }
+        for (int i = m; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                cost[i * n + j] = max_sim;
+            }
+        }
+
+        const double INF = 1e18;
+        for (int j = 0; j <= n; j++) {
+            p[j] = 0;
+            v[j] = 0;
+            way[j] = 0;
+        }
+        for (int i = 0; i <= n; i++) u[i] = 0;
 
-        for (int u = 0; u < leftNum; u++) {
-            while (1) {
-                for (int i = 0; i < leftNum; i++) leftUsed[i] = false;
-                for (int i = 0; i < rightNum; i++) rightUsed[i] = false;
-                if (matchDfs(u)) break;
-                double d = 1e10;
-                for (int i = 0; i < leftNum; i++) {
-                    if (leftUsed[i] ) {
-                        for (int j = 0; j < rightNum; j++) {
-                            if (!rightUsed[j]) d = min(d, leftWeight[i] + rightWeight[j] - mat[i][j]);
-                        }
+        for (int i = 1; i <= n; i++) {
+            p[0] = i;
+            int j0 = 0;
+            for (int j = 0; j <= n; j++) {
+                minv[j] = INF;
+                used[j] = 0;
+            }
+            do {
+                used[j0] = 1;
+                int i0 = p[j0], j1 = 0;
+                double delta = INF;
+                for (int j = 1; j <= n; j++) {
+                    if (used[j]) continue;
+                    double cur = cost[(i0 - 1) * n + (j - 1)] - u[i0] - v[j];
+                    if (cur < minv[j]) {
+                        minv[j] = cur;
+                        way[j] = j0;
+                    }
+                    if (minv[j] < delta) {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+                for (int j = 0; j <= n; j++) {
+                    if (used[j]) {
+                        u[p[j]] += delta;
+                        v[j] -= delta;
+                    } else {
+                        minv[j] -= delta;
                     }
                 }
-                if (d == 1e10) return ;
-                for (int i = 0; i < leftNum; i++) if (leftUsed[i]) leftWeight[i] -= d;
-                for (int i = 0; i < rightNum; i++) if (rightUsed[i]) rightWeight[i] += d;
+                j0 = j1;
+            } while (p[j0] != 0);
+            do {
+                int j1 = way[j0];
+                p[j0] = p[j1];
+                j0 = j1;
+            } while (j0);
+        }
+
+        leftMatch.assign(m, -1);
+        rightMatch.assign(n, -1);
+        for (int j = 1; j <= n; j++) {
+            int i = p[j] - 1;  // row matched to column j-1
+            if (i >= 0 && i < m) {
+                leftMatch[i] = j - 1;
+                rightMatch[j - 1] = i;
             }
         }
+        if (exchanged) swap(leftMatch, rightMatch);
+    }
+
+private:
+    void reserve(int n) {
+        if ((int)u.size() >= n + 1 && (int)cost.size() >= n * n) return;
+        cost.resize(n * n);
+        u.resize(n + 1);
+        v.resize(n + 1);
+        minv.resize(n + 1);
+        p.resize(n + 1);
+        way.resize(n + 1);
+        used.resize(n + 1);
     }
-};
 
+    vector<double> cost;          // flat row-major, square after padding
+    vector<double> u, v, minv;    // dual potentials and path slacks
+    vector<int> p, way;
+    vector<char> used;
+};
 
 #endif // HUNGARIAN_GRAPH_HPP
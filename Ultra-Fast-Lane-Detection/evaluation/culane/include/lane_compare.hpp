@@ -25,8 +25,20 @@ class LaneCompare{
 		}
 
 		double get_lane_similarity(const vector<Point2f> &lane1, const vector<Point2f> &lane2);
+		// variant taking lanes already interpolated with interp_lane_into;
+		// lets the caller interpolate each lane once per image instead of
+		// once per pairing
+		double get_lane_similarity_interp(const vector<Point2f> &p_interp1, const vector<Point2f> &p_interp2);
+		void interp_lane_into(const vector<Point2f> &lane, vector<Point2f> &p_interp);
+		// reference implementation: rasterizes both lanes into Mats and
+		// measures pixel overlap; kept for validating the geometric path
+		double get_lane_similarity_raster(const vector<Point2f> &lane1, const vector<Point2f> &lane2);
 		void resize_lane(vector<Point2f> &curr_lane, int curr_width, int curr_height);
 	private:
+		// per-row x-intervals covered by one stroked polyline
+		void stroke_intervals(const vector<Point2f> &p_interp, vector<vector<pair<float, float> > > &rows, int &row_min, int &row_max);
+		vector<Point2f> interp_lane(const vector<Point2f> &lane);
+
 		CompareMode compare_mode;
 		int im_width;
 		int im_height;
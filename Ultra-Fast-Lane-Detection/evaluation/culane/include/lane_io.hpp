@@ -0,0 +1,59 @@
+#ifndef LANE_IO_HPP
+#define LANE_IO_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <opencv2/core.hpp>
+
+using namespace std;
+using namespace cv;
+
+// Fast reader for .lines.txt lane files: memory-maps the file and parses
+// coordinates with a hand-rolled float scanner straight from the mapped
+// bytes. Points are staged in a thread-local flat arena whose capacity is
+// reused across files, so steady-state parsing does no per-point
+// allocations. Missing files yield an empty lane list, matching the old
+// ifstream behaviour.
+void read_lane_file_mmap(const string &file_name, vector<vector<Point2f> > &lanes);
+
+// FNV-1a hash of a file's raw bytes, for the incremental evaluation
+// cache. Returns 0 for a missing or empty file.
+unsigned long long hash_file_fnv1a(const string &file_name);
+
+// ---- binary columnar lane pack ----
+// One file per dataset split instead of one .lines.txt per image. Layout
+// (little-endian, all offsets absolute byte positions):
+//   char     magic[4] = "LPK1"
+//   uint32   image_count
+//   image_count records: u64 name_off, u32 name_len, u64 lane_off, u32 lane_count
+//   lane records:        u64 point_off, u32 point_count
+//   point payload:       float32 x,y pairs
+//   name blob
+// The reader mmaps the pack once and serves any image's lanes straight
+// out of the mapping, so a full evaluation does two file opens instead
+// of ~200k.
+class LanePack
+{
+	public:
+		LanePack() : data_(NULL), size_(0) {}
+		~LanePack();
+
+		bool open(const string &path);
+		bool is_open() const { return data_ != NULL; }
+		// key is the per-image .lines.txt relative path used in the index;
+		// returns false when the key is not in the pack
+		bool get(const string &key, vector<vector<Point2f> > &lanes) const;
+
+	private:
+		const unsigned char *data_;
+		size_t size_;
+		// key -> (lane_off, lane_count)
+		unordered_map<string, pair<unsigned long long, unsigned> > index_;
+};
+
+// Writes a pack; keys[i] names lanes[i]. Returns false on I/O failure.
+bool write_lane_pack(const string &path, const vector<string> &keys,
+		const vector<vector<vector<Point2f> > > &lanes);
+
+#endif
@@ -22,6 +22,10 @@ struct Func {
 class Spline {
 public:
 	vector<Point2f> splineInterpTimes(const vector<Point2f> &tmp_line, int times);
+	// batch form: appends the interpolated points into caller-provided
+	// storage so the evaluator can reuse one buffer per lane; the cubic is
+	// evaluated in Horner form and the sample loop vectorizes (omp simd)
+	void splineInterpTimesInto(const vector<Point2f> &tmp_line, int times, vector<Point2f> &res);
     vector<Point2f> splineInterpStep(vector<Point2f> tmp_line, double step);
 	vector<Func> cal_fun(const vector<Point2f> &point_v);
 };
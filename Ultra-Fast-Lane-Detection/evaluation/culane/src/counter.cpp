@@ -73,15 +73,25 @@ tuple<vector<int>, long, long, long, long> Counter::count_im_pair(const vector<v
 	}
 	// hungarian match first
 	
+	// interpolate each lane once; every pairing used to re-spline both sides
+	vector<vector<Point2f> > anno_interp(anno_lanes.size());
+	vector<vector<Point2f> > detect_interp(detect_lanes.size());
+	for(int i=0; i<anno_lanes.size(); i++)
+	{
+		lane_compare->interp_lane_into(anno_lanes[i], anno_interp[i]);
+	}
+	for(int j=0; j<detect_lanes.size(); j++)
+	{
+		lane_compare->interp_lane_into(detect_lanes[j], detect_interp[j]);
+	}
+
 	// first calc similarity matrix
 	vector<vector<double> > similarity(anno_lanes.size(), vector<double>(detect_lanes.size(), 0));
 	for(int i=0; i<anno_lanes.size(); i++)
 	{
-		const vector<Point2f> &curr_anno_lane = anno_lanes[i];
 		for(int j=0; j<detect_lanes.size(); j++)
 		{
-			const vector<Point2f> &curr_detect_lane = detect_lanes[j];
-			similarity[i][j] = lane_compare->get_lane_similarity(curr_anno_lane, curr_detect_lane);
+			similarity[i][j] = lane_compare->get_lane_similarity_interp(anno_interp[i], detect_interp[j]);
 		}
 	}
 
@@ -112,23 +122,9 @@ tuple<vector<int>, long, long, long, long> Counter::count_im_pair(const vector<v
 void Counter::makeMatch(const vector<vector<double> > &similarity, vector<int> &match1, vector<int> &match2) {
 	int m = similarity.size();
 	int n = similarity[0].size();
-    pipartiteGraph gra;
-    bool have_exchange = false;
-    if (m > n) {
-        have_exchange = true;
-        swap(m, n);
-    }
-    gra.resize(m, n);
-    for (int i = 0; i < gra.leftNum; i++) {
-        for (int j = 0; j < gra.rightNum; j++) {
-			if(have_exchange)
-				gra.mat[i][j] = similarity[j][i];
-			else
-				gra.mat[i][j] = similarity[i][j];
-        }
-    }
-    gra.match();
-    match1 = gra.leftMatch;
-    match2 = gra.rightMatch;
-    if (have_exchange) swap(match1, match2);
+	bool have_exchange = m > n;
+	// one solver per worker thread: its flat cost matrix and dual arrays
+	// are reused across every image pair the thread processes
+	static thread_local AssignmentSolver solver;
+	solver.solve(similarity, have_exchange, match1, match2);
 }
@@ -7,18 +7,28 @@
 
 #include "counter.hpp"
 #include "spline.hpp"
+#include "lane_io.hpp"
 #if __linux__
 #include <unistd.h>
+#include <sys/stat.h>
 #elif _MSC_VER
 #include "getopt.h"
 #endif
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstdio>
 #include <cstdlib>
+#include <chrono>
 #include <string>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
+#include <opencv2/imgcodecs.hpp>
 using namespace std;
 using namespace cv;
 
@@ -36,11 +46,310 @@ void help(void)
 	cout<<"-r                  : rows (max image height) (default: 1080)"<<endl;
 	cout<<"-s                  : show visualization"<<endl;
 	cout<<"-f                  : start frame in the test set (default: 1)"<<endl;
+	cout<<"-e                  : incremental cache index file; images whose anno/detect files are unchanged are served from the cache"<<endl;
+	cout<<"-A                  : annotation lane pack (see lane_pack tool); overrides per-image files under -a"<<endl;
+	cout<<"-D                  : detection lane pack; overrides per-image files under -d"<<endl;
+	cout<<"-S                  : shard spec i/N; process every N-th image starting at i (0-based) and write a partial dump via -P"<<endl;
+	cout<<"-P                  : partial result dump file (required with -S)"<<endl;
+	cout<<"-M                  : merge mode; remaining arguments are shard dumps, combined into final precision/recall/F-measure"<<endl;
+	cout<<"-x                  : export overlays of images with any FP/FN into this directory (non-interactive -s)"<<endl;
 }
 
+typedef tuple<vector<int>, long, long, long, long> ImResult;
+
+// ---- incremental evaluation cache ----
+// On-disk index mapping each filelist entry to a content hash of its
+// anno/detect files plus the cached count_im_pair tuple. Between CI runs
+// typically <5% of prediction files change, so everything else skips
+// lane parsing and matching entirely.
+
+struct CacheEntry
+{
+	unsigned long long hash;
+	ImResult result;
+};
+
+void load_eval_cache(const string &file_name, unordered_map<string, CacheEntry> &cache)
+{
+	ifstream ifs(file_name, ios::in);
+	if(ifs.fail())
+	{
+		return;
+	}
+	string name;
+	while(ifs>>name)
+	{
+		CacheEntry entry;
+		long tp, fp, tn, fn;
+		size_t num_match;
+		if(!(ifs>>entry.hash>>tp>>fp>>tn>>fn>>num_match))
+		{
+			break;
+		}
+		vector<int> match(num_match);
+		for(size_t m=0; m<num_match; m++)
+		{
+			ifs>>match[m];
+		}
+		entry.result = make_tuple(match, tp, fp, tn, fn);
+		cache[name] = entry;
+	}
+}
+
+void save_eval_cache(const string &file_name, const vector<string> &filelists,
+		const vector<unsigned long long> &hashes, const vector<ImResult> &tuple_lists)
+{
+	ofstream ofs(file_name, ios::out);
+	if(ofs.fail())
+	{
+		cerr<<"Warning: cannot write cache file "<<file_name<<endl;
+		return;
+	}
+	for(size_t i=0; i<filelists.size(); i++)
+	{
+		const vector<int> &match = get<0>(tuple_lists[i]);
+		ofs<<filelists[i]<<" "<<hashes[i]<<" "
+			<<get<1>(tuple_lists[i])<<" "<<get<2>(tuple_lists[i])<<" "
+			<<get<3>(tuple_lists[i])<<" "<<get<4>(tuple_lists[i])<<" "<<match.size();
+		for(size_t m=0; m<match.size(); m++)
+		{
+			ofs<<" "<<match[m];
+		}
+		ofs<<"\n";
+	}
+}
+
+// ---- sharded evaluation ----
+// Counter aggregation is a plain sum of per-image tp/fp/fn, so a run can
+// be fanned out: each shard processes a deterministic modulo slice of
+// the filelist and dumps its per-image counts; -M merges the dumps into
+// the final totals. Dump layout (little-endian):
+//   char   magic[4] = "LSH1"
+//   uint32 total_images (full filelist length, for coverage checking)
+//   uint32 record_count
+//   records: u32 index, i64 tp, i64 fp, i64 tn, i64 fn
+
+bool write_shard_dump(const string &file_name, unsigned total_images,
+		const vector<unsigned> &indices, const vector<ImResult> &tuple_lists)
+{
+	ofstream ofs(file_name, ios::out | ios::binary);
+	if(ofs.fail())
+	{
+		return false;
+	}
+	ofs.write("LSH1", 4);
+	unsigned record_count = indices.size();
+	ofs.write((const char *)&total_images, 4);
+	ofs.write((const char *)&record_count, 4);
+	for(size_t n=0; n<indices.size(); n++)
+	{
+		unsigned idx = indices[n];
+		long long counts[4] = {
+			get<1>(tuple_lists[idx]), get<2>(tuple_lists[idx]),
+			get<3>(tuple_lists[idx]), get<4>(tuple_lists[idx])
+		};
+		ofs.write((const char *)&idx, 4);
+		ofs.write((const char *)counts, sizeof(counts));
+	}
+	return ofs.good();
+}
+
+// Combines shard dumps; fails if any image is missing or duplicated, or
+// if the dumps disagree on the filelist length.
+bool merge_shard_dumps(const vector<string> &dump_files, long &tp, long &fp, long &fn)
+{
+	tp = fp = fn = 0;
+	unsigned total_images = 0;
+	vector<char> seen;
+	for(size_t d=0; d<dump_files.size(); d++)
+	{
+		ifstream ifs(dump_files[d], ios::in | ios::binary);
+		if(ifs.fail())
+		{
+			cerr<<"Error: cannot open shard dump "<<dump_files[d]<<endl;
+			return false;
+		}
+		char magic[4];
+		unsigned total, record_count;
+		ifs.read(magic, 4);
+		ifs.read((char *)&total, 4);
+		ifs.read((char *)&record_count, 4);
+		if(!ifs.good() || string(magic, 4) != "LSH1")
+		{
+			cerr<<"Error: "<<dump_files[d]<<" is not a shard dump"<<endl;
+			return false;
+		}
+		if(seen.empty())
+		{
+			total_images = total;
+			seen.assign(total_images, 0);
+		}
+		else if(total != total_images)
+		{
+			cerr<<"Error: "<<dump_files[d]<<" covers "<<total
+				<<" images, other shards cover "<<total_images<<endl;
+			return false;
+		}
+		for(unsigned n=0; n<record_count; n++)
+		{
+			unsigned idx;
+			long long counts[4];
+			ifs.read((char *)&idx, 4);
+			ifs.read((char *)counts, sizeof(counts));
+			if(!ifs.good() || idx >= total_images)
+			{
+				cerr<<"Error: corrupt record in "<<dump_files[d]<<endl;
+				return false;
+			}
+			if(seen[idx])
+			{
+				cerr<<"Error: image "<<idx<<" appears in more than one shard"<<endl;
+				return false;
+			}
+			seen[idx] = 1;
+			tp += counts[0];
+			fp += counts[1];
+			fn += counts[3];
+		}
+	}
+	long missing = 0;
+	for(size_t n=0; n<seen.size(); n++)
+	{
+		if(!seen[n])
+		{
+			missing++;
+		}
+	}
+	if(missing > 0)
+	{
+		cerr<<"Error: "<<missing<<" of "<<total_images<<" images missing from the shard dumps"<<endl;
+		return false;
+	}
+	return true;
+}
 
 void read_lane_file(const string &file_name, vector<vector<Point2f> > &lanes);
 void visualize(string &full_im_name, vector<vector<Point2f> > &anno_lanes, vector<vector<Point2f> > &detect_lanes, vector<int> anno_match, int width_lane);
+Mat render_overlay(const string &full_im_name, const vector<vector<Point2f> > &anno_lanes, const vector<vector<Point2f> > &detect_lanes, const vector<int> &anno_match, int width_lane);
+
+// ---- asynchronous visualization export ----
+// Non-interactive replacement for -s on big runs: any image that
+// produced a false positive or false negative is queued to one writer
+// thread, which renders the overlay and encodes it to disk. The workers
+// pay a queue push instead of imshow/waitKey inside the parallel loop,
+// and the bounded queue blocks them briefly if the encoder falls behind
+// rather than buffering thousands of decoded frames.
+
+struct ExportJob
+{
+	string sub_im_name;
+	vector<vector<Point2f> > anno_lanes;
+	vector<vector<Point2f> > detect_lanes;
+	vector<int> anno_match;
+};
+
+class ExportWriter
+{
+	public:
+		ExportWriter(const string &dir, const string &im_dir, int width_lane)
+			: dir_(dir), im_dir_(im_dir), width_lane_(width_lane),
+			  closed_(false), exported_(0), worker_(&ExportWriter::run, this)
+		{
+		}
+
+		// called from the OpenMP workers; blocks while the queue is full
+		void push(ExportJob job)
+		{
+			unique_lock<mutex> lock(mu_);
+			while(queue_.size() >= kMaxQueued && !closed_)
+			{
+				not_full_.wait(lock);
+			}
+			if(closed_)
+			{
+				return;
+			}
+			queue_.push_back(move(job));
+			not_empty_.notify_one();
+		}
+
+		// drains the queue, stops the worker and reports how many images
+		// were written
+		long finish()
+		{
+			{
+				lock_guard<mutex> lock(mu_);
+				closed_ = true;
+			}
+			not_empty_.notify_all();
+			not_full_.notify_all();
+			worker_.join();
+			return exported_;
+		}
+
+	private:
+		static const size_t kMaxQueued = 64;
+
+		void run()
+		{
+			while(true)
+			{
+				ExportJob job;
+				{
+					unique_lock<mutex> lock(mu_);
+					while(queue_.empty() && !closed_)
+					{
+						not_empty_.wait(lock);
+					}
+					if(queue_.empty())
+					{
+						return;  // closed and drained
+					}
+					job = move(queue_.front());
+					queue_.pop_front();
+					not_full_.notify_one();
+				}
+				write(job);
+			}
+		}
+
+		void write(const ExportJob &job)
+		{
+			Mat img = render_overlay(im_dir_ + job.sub_im_name, job.anno_lanes,
+					job.detect_lanes, job.anno_match, width_lane_);
+			if(img.empty())
+			{
+				return;
+			}
+			// flatten the dataset-relative path into one file name
+			string name = job.sub_im_name;
+			for(size_t n=0; n<name.size(); n++)
+			{
+				if(name[n] == '/')
+				{
+					name[n] = '_';
+				}
+			}
+			while(!name.empty() && name[0] == '_')
+			{
+				name.erase(0, 1);
+			}
+			if(imwrite(dir_ + "/" + name, img))
+			{
+				exported_++;
+			}
+		}
+
+		string dir_;
+		string im_dir_;
+		int width_lane_;
+		bool closed_;
+		long exported_;
+		deque<ExportJob> queue_;
+		mutex mu_;
+		condition_variable not_empty_, not_full_;
+		thread worker_;
+};
 
 int main(int argc, char **argv)
 {
@@ -50,6 +359,15 @@ int main(int argc, char **argv)
 	string im_dir = "/data/driving/eval_data/img/";
 	string list_im_file = "/data/driving/eval_data/img/all.txt";
 	string output_file = "./output.txt";
+	string cache_file = "";
+	string anno_pack_file = "";
+	string detect_pack_file = "";
+	string shard_spec = "";
+	string partial_file = "";
+	string export_dir = "";
+	bool merge_mode = false;
+	int shard_index = 0;
+	int shard_count = 1;
 	int width_lane = 10;
 	double iou_threshold = 0.4;
 	int im_width = 1920;
@@ -57,7 +375,7 @@ int main(int argc, char **argv)
 	int oc;
 	bool show = false;
 	int frame = 1;
-	while((oc = getopt(argc, argv, "ha:d:i:l:w:t:c:r:sf:o:")) != -1)
+	while((oc = getopt(argc, argv, "ha:d:i:l:w:t:c:r:sf:o:e:A:D:S:P:Mx:")) != -1)
 	{
 		switch(oc)
 		{
@@ -97,10 +415,92 @@ int main(int argc, char **argv)
 			case 'o':
 				output_file = optarg;
 				break;
+			case 'e':
+				cache_file = optarg;
+				break;
+			case 'A':
+				anno_pack_file = optarg;
+				break;
+			case 'D':
+				detect_pack_file = optarg;
+				break;
+			case 'S':
+				shard_spec = optarg;
+				break;
+			case 'P':
+				partial_file = optarg;
+				break;
+			case 'M':
+				merge_mode = true;
+				break;
+			case 'x':
+				export_dir = optarg;
+				break;
 		}
 	}
 
 
+	if(merge_mode)
+	{
+		vector<string> dump_files;
+		for(int n=optind; n<argc; n++)
+		{
+			dump_files.push_back(argv[n]);
+		}
+		if(dump_files.empty())
+		{
+			cerr<<"Error: -M needs at least one shard dump"<<endl;
+			help();
+			return 1;
+		}
+		long tp, fp, fn;
+		if(!merge_shard_dumps(dump_files, tp, fp, fn))
+		{
+			return 1;
+		}
+		Counter counter(im_width, im_height, iou_threshold, width_lane);
+		counter.setTP(tp);
+		counter.setFP(fp);
+		counter.setFN(fn);
+		double precision = counter.get_precision();
+		double recall = counter.get_recall();
+		double F = 2 * precision * recall / (precision + recall);
+		cerr<<"merged "<<dump_files.size()<<" shard dumps"<<endl;
+		cout<<"precision: "<<precision<<endl;
+		cout<<"recall: "<<recall<<endl;
+		cout<<"Fmeasure: "<<F<<endl;
+		cout<<"----------------------------------"<<endl;
+		ofstream ofs_out_file(output_file, ios::out);
+		ofs_out_file<<"file: "<<output_file<<endl;
+		ofs_out_file<<"tp: "<<tp<<" fp: "<<fp<<" fn: "<<fn<<endl;
+		ofs_out_file<<"precision: "<<precision<<endl;
+		ofs_out_file<<"recall: "<<recall<<endl;
+		ofs_out_file<<"Fmeasure: "<<F<<endl<<endl;
+		return 0;
+	}
+
+	if(!shard_spec.empty())
+	{
+		if(sscanf(shard_spec.c_str(), "%d/%d", &shard_index, &shard_count) != 2
+				|| shard_count < 1 || shard_index < 0 || shard_index >= shard_count)
+		{
+			cerr<<"Error: bad shard spec "<<shard_spec<<" (expected i/N with 0 <= i < N)"<<endl;
+			return 1;
+		}
+		if(partial_file.empty())
+		{
+			cerr<<"Error: -S requires a partial dump file via -P"<<endl;
+			return 1;
+		}
+		if(!cache_file.empty())
+		{
+			// the cache file stores one row per filelist entry; a shard
+			// would fill the unprocessed rows with garbage
+			cerr<<"Warning: -e is ignored when sharding"<<endl;
+			cache_file = "";
+		}
+	}
+
 	cout<<"------------Configuration---------"<<endl;
 	cout<<"anno_dir: "<<anno_dir<<endl;
 	cout<<"detect_dir: "<<detect_dir<<endl;
@@ -130,8 +530,46 @@ int main(int argc, char **argv)
 	}
 
 
+	// lane packs: one mmapped file per side instead of one .lines.txt per
+	// image; per-image files are still the fallback for keys not packed
+	LanePack anno_pack, detect_pack;
+	if(!anno_pack_file.empty() && !anno_pack.open(anno_pack_file))
+	{
+		cerr<<"Error: cannot open annotation pack "<<anno_pack_file<<endl;
+		return 1;
+	}
+	if(!detect_pack_file.empty() && !detect_pack.open(detect_pack_file))
+	{
+		cerr<<"Error: cannot open detection pack "<<detect_pack_file<<endl;
+		return 1;
+	}
+	if((anno_pack.is_open() || detect_pack.is_open()) && !cache_file.empty())
+	{
+		// the cache keys on per-image file hashes, which do not exist for
+		// packed input; pack reads are cheap enough not to need it
+		cerr<<"Warning: -e is ignored when a lane pack is used"<<endl;
+		cache_file = "";
+	}
+
+	// overlay export: one writer thread, fed failed-match images from the
+	// parallel loop
+	ExportWriter *exporter = NULL;
+	if(!export_dir.empty())
+	{
+#if __linux__
+		mkdir(export_dir.c_str(), 0755);  // EEXIST is fine
+#endif
+		if(!cache_file.empty())
+		{
+			// cache hits skip lane parsing, so only recomputed images can
+			// be exported
+			cerr<<"Warning: with -e, only images not served from the cache are exported"<<endl;
+		}
+		exporter = new ExportWriter(export_dir, im_dir, width_lane);
+	}
+
 	Counter counter(im_width, im_height, iou_threshold, width_lane);
-	
+
 	vector<int> anno_match;
 	string sub_im_name;
   // pre-load filelist
@@ -144,26 +582,129 @@ int main(int argc, char **argv)
   vector<tuple<vector<int>, long, long, long, long>> tuple_lists;
   tuple_lists.resize(filelists.size());
 
-#pragma omp parallel for
-	for (int i = 0; i < filelists.size(); i++)
+	// Per-image cost varies wildly (empty images do no IoU work, busy ones
+	// do dozens of comparisons), so a static schedule leaves threads idle
+	// behind stragglers; small dynamic chunks keep every worker fed.
+	long progress = 0;
+	long cache_hits = 0;
+	auto eval_start = chrono::steady_clock::now();
+
+	unordered_map<string, CacheEntry> cache;
+	if (!cache_file.empty())
+	{
+		load_eval_cache(cache_file, cache);
+	}
+	vector<unsigned long long> hashes(filelists.size(), 0);
+
+	// shard slice; all indices when not sharding. The modulo interleave
+	// spreads hard scenes evenly over shards instead of giving one shard
+	// a whole difficult recording.
+	vector<unsigned> shard_indices;
+	for (unsigned n = shard_index; n < filelists.size(); n += shard_count)
+	{
+		shard_indices.push_back(n);
+	}
+
+#pragma omp parallel for schedule(dynamic, 16)
+	for (int k = 0; k < (int)shard_indices.size(); k++)
 	{
+		int i = shard_indices[k];
 		auto sub_im_name = filelists[i];
 		string full_im_name = im_dir + sub_im_name;
 		string sub_txt_name =  sub_im_name.substr(0, sub_im_name.find_last_of(".")) + ".lines.txt";
 		string anno_file_name = anno_dir + sub_txt_name;
 		string detect_file_name = detect_dir + sub_txt_name;
-		vector<vector<Point2f> > anno_lanes;
-		vector<vector<Point2f> > detect_lanes;
-		read_lane_file(anno_file_name, anno_lanes);
-		read_lane_file(detect_file_name, detect_lanes);
-		//cerr<<count<<": "<<full_im_name<<endl;
-		tuple_lists[i] = counter.count_im_pair(anno_lanes, detect_lanes);
-		if (show)
-		{
-			auto anno_match = get<0>(tuple_lists[i]);
-			visualize(full_im_name, anno_lanes, detect_lanes, anno_match, width_lane);
-			waitKey(0);
+
+		bool cached = false;
+		if (!cache_file.empty())
+		{
+			unsigned long long h = hash_file_fnv1a(anno_file_name);
+			h = h * 1099511628211ULL ^ hash_file_fnv1a(detect_file_name);
+			hashes[i] = h;
+			// the map is read-only during the parallel loop
+			auto it = cache.find(sub_im_name);
+			if (it != cache.end() && it->second.hash == h && !show)
+			{
+				tuple_lists[i] = it->second.result;
+				cached = true;
+#pragma omp atomic
+				cache_hits++;
+			}
 		}
+
+		if (!cached)
+		{
+			vector<vector<Point2f> > anno_lanes;
+			vector<vector<Point2f> > detect_lanes;
+			if(!anno_pack.is_open() || !anno_pack.get(sub_txt_name, anno_lanes))
+			{
+				read_lane_file(anno_file_name, anno_lanes);
+			}
+			if(!detect_pack.is_open() || !detect_pack.get(sub_txt_name, detect_lanes))
+			{
+				read_lane_file(detect_file_name, detect_lanes);
+			}
+			//cerr<<count<<": "<<full_im_name<<endl;
+			tuple_lists[i] = counter.count_im_pair(anno_lanes, detect_lanes);
+			if (exporter && (get<2>(tuple_lists[i]) > 0 || get<4>(tuple_lists[i]) > 0))
+			{
+				ExportJob job;
+				job.sub_im_name = sub_im_name;
+				job.anno_lanes = anno_lanes;
+				job.detect_lanes = detect_lanes;
+				job.anno_match = get<0>(tuple_lists[i]);
+				exporter->push(move(job));
+			}
+			if (show)
+			{
+				auto anno_match = get<0>(tuple_lists[i]);
+				visualize(full_im_name, anno_lanes, detect_lanes, anno_match, width_lane);
+				waitKey(0);
+			}
+		}
+
+		long done;
+#pragma omp atomic capture
+		done = ++progress;
+		if (done % 500 == 0 || done == (long)shard_indices.size())
+		{
+			double elapsed = chrono::duration<double>(chrono::steady_clock::now() - eval_start).count();
+			double rate = done / max(elapsed, 1e-6);
+			long remain = shard_indices.size() - done;
+			cerr<<"\r"<<done<<"/"<<shard_indices.size()
+				<<" ("<<(long)rate<<" im/s, ETA "<<(long)(remain / max(rate, 1e-6))<<" s)   "<<flush;
+			if (done == (long)shard_indices.size())
+			{
+				cerr<<endl;
+			}
+		}
+	}
+
+	if (exporter)
+	{
+		long exported = exporter->finish();
+		cerr<<"export: "<<exported<<" failed-match overlays written to "<<export_dir<<endl;
+		delete exporter;
+	}
+
+	if (!cache_file.empty())
+	{
+		save_eval_cache(cache_file, filelists, hashes, tuple_lists);
+		cerr<<"cache: "<<cache_hits<<"/"<<filelists.size()<<" images served from "<<cache_file<<endl;
+	}
+
+	// any -S run dumps, including a single-shard -S 0/1 rehearsal of the
+	// distributed flow, so a later -M always has its input
+	if (!shard_spec.empty())
+	{
+		if (!write_shard_dump(partial_file, filelists.size(), shard_indices, tuple_lists))
+		{
+			cerr<<"Error: cannot write partial dump "<<partial_file<<endl;
+			return 1;
+		}
+		cerr<<"shard "<<shard_index<<"/"<<shard_count<<": "<<shard_indices.size()
+			<<" images dumped to "<<partial_file<<" (merge all shards with -M)"<<endl;
+		return 0;
 	}
 
 	long tp = 0, fp = 0, tn = 0, fn = 0;
@@ -199,28 +740,9 @@ int main(int argc, char **argv)
 
 void read_lane_file(const string &file_name, vector<vector<Point2f> > &lanes)
 {
-	lanes.clear();
-	ifstream ifs_lane(file_name, ios::in);
-	if(ifs_lane.fail())
-	{
-		return;
-	}
-
-	string str_line;
-	while(getline(ifs_lane, str_line))
-	{
-		vector<Point2f> curr_lane;
-		stringstream ss;
-		ss<<str_line;
-		double x,y;
-		while(ss>>x>>y)
-		{
-			curr_lane.push_back(Point2f(x, y));
-		}
-		lanes.push_back(curr_lane);
-	}
-
-	ifs_lane.close();
+	// mmap + custom float scanning (lane_io.cpp); the old per-line
+	// stringstream parsing dominated warm-up on network storage
+	read_lane_file_mmap(file_name, lanes);
 }
 
 void visualize(string &full_im_name, vector<vector<Point2f> > &anno_lanes, vector<vector<Point2f> > &detect_lanes, vector<int> anno_match, int width_lane)
@@ -300,3 +822,84 @@ void visualize(string &full_im_name, vector<vector<Point2f> > &anno_lanes, vecto
 	namedWindow("visualize2", 1);
 	imshow("visualize2", img2);
 }
+
+// Headless counterpart of visualize() for the -x export path: same
+// colour scheme (annotation green, matched detection blue, unmatched
+// red) drawn thin, returned instead of shown. An unreadable image comes
+// back empty and the caller skips it.
+Mat render_overlay(const string &full_im_name, const vector<vector<Point2f> > &anno_lanes, const vector<vector<Point2f> > &detect_lanes, const vector<int> &anno_match, int width_lane)
+{
+	Mat img = imread(full_im_name, 1);
+	if (img.empty())
+	{
+		return img;
+	}
+	vector<Point2f> curr_lane;
+	vector<Point2f> p_interp;
+	Spline splineSolver;
+	Scalar color_B = Scalar(255, 0, 0);
+	Scalar color_G = Scalar(0, 255, 0);
+	Scalar color_R = Scalar(0, 0, 255);
+	Scalar color;
+	for (int i=0; i<anno_lanes.size(); i++)
+	{
+		curr_lane = anno_lanes[i];
+		if(curr_lane.size() == 2)
+		{
+			p_interp = curr_lane;
+		}
+		else
+		{
+			p_interp = splineSolver.splineInterpTimes(curr_lane, 50);
+		}
+		if (p_interp.size() < 2)
+		{
+			// single-point lanes (one row anchor fired) have no segments;
+			// size()-1 below would wrap and read out of bounds
+			continue;
+		}
+		for (int n=0; n<p_interp.size()-1; n++)
+		{
+			line(img, p_interp[n], p_interp[n+1], color_G, 2);
+		}
+	}
+	bool detected;
+	for (int i=0; i<detect_lanes.size(); i++)
+	{
+		detected = false;
+		curr_lane = detect_lanes[i];
+		if(curr_lane.size() == 2)
+		{
+			p_interp = curr_lane;
+		}
+		else
+		{
+			p_interp = splineSolver.splineInterpTimes(curr_lane, 50);
+		}
+		for (int n=0; n<anno_lanes.size(); n++)
+		{
+			if (anno_match[n] == i)
+			{
+				detected = true;
+				break;
+			}
+		}
+		if (p_interp.size() < 2)
+		{
+			continue;
+		}
+		if (detected == true)
+		{
+			color = color_B;
+		}
+		else
+		{
+			color = color_R;
+		}
+		for (int n=0; n<p_interp.size()-1; n++)
+		{
+			line(img, p_interp[n], p_interp[n+1], color, 2);
+		}
+	}
+	return img;
+}
@@ -6,6 +6,87 @@
  ************************************************************************/
 
 #include "lane_compare.hpp"
+#include <algorithm>
+
+namespace
+{
+	// Merged length of a set of [start, end) intervals on one row.
+	// Sorts in place; n is small (one entry per stroked segment).
+	double union_length(vector<pair<float, float> > &spans)
+	{
+		if(spans.empty())
+		{
+			return 0;
+		}
+		sort(spans.begin(), spans.end());
+		double total = 0;
+		float lo = spans[0].first, hi = spans[0].second;
+		for(size_t n=1; n<spans.size(); n++)
+		{
+			if(spans[n].first > hi)
+			{
+				total += hi - lo;
+				lo = spans[n].first;
+				hi = spans[n].second;
+			}
+			else
+			{
+				hi = max(hi, spans[n].second);
+			}
+		}
+		total += hi - lo;
+		return total;
+	}
+
+	// Overlap length of two merged (sorted, disjoint) interval sets.
+	double intersection_length(const vector<pair<float, float> > &a, const vector<pair<float, float> > &b)
+	{
+		double total = 0;
+		size_t i = 0, j = 0;
+		while(i < a.size() && j < b.size())
+		{
+			float lo = max(a[i].first, b[j].first);
+			float hi = min(a[i].second, b[j].second);
+			if(hi > lo)
+			{
+				total += hi - lo;
+			}
+			if(a[i].second < b[j].second)
+			{
+				i++;
+			}
+			else
+			{
+				j++;
+			}
+		}
+		return total;
+	}
+
+	// Merge intervals in place into sorted disjoint form.
+	void merge_spans(vector<pair<float, float> > &spans)
+	{
+		if(spans.empty())
+		{
+			return;
+		}
+		sort(spans.begin(), spans.end());
+		size_t out = 0;
+		for(size_t n=1; n<spans.size(); n++)
+		{
+			if(spans[n].first > spans[out].second)
+			{
+				out++;
+				spans[out] = spans[n];
+			}
+			else
+			{
+				spans[out].second = max(spans[out].second, spans[n].second);
+			}
+		}
+		spans.resize(out + 1);
+	}
+}
 
 double LaneCompare::get_lane_similarity(const vector<Point2f> &lane1, const vector<Point2f> &lane2)
 {
@@ -14,29 +95,210 @@ double LaneCompare::get_lane_similarity(const vector<Point2f> &lane1, const vect
 		cerr<<"lane size must be greater or equal to 2"<<endl;
 		return 0;
 	}
-	Mat im1 = Mat::zeros(im_height, im_width, CV_8UC1);
-	Mat im2 = Mat::zeros(im_height, im_width, CV_8UC1);
-	// draw lines on im1 and im2
-	vector<Point2f> p_interp1;
-	vector<Point2f> p_interp2;
-	if(lane1.size() == 2)
+	return get_lane_similarity_interp(interp_lane(lane1), interp_lane(lane2));
+}
+
+void LaneCompare::interp_lane_into(const vector<Point2f> &lane, vector<Point2f> &p_interp)
+{
+	if(lane.size() == 2)
 	{
-		p_interp1 = lane1;
+		p_interp = lane;
+	}
+	else if(lane.size() > 2)
+	{
+		splineSolver.splineInterpTimesInto(lane, 50, p_interp);
 	}
 	else
 	{
-		p_interp1 = splineSolver.splineInterpTimes(lane1, 50);
+		p_interp.clear();
+	}
+}
+
+double LaneCompare::get_lane_similarity_interp(const vector<Point2f> &p_interp1, const vector<Point2f> &p_interp2)
+{
+	if(p_interp1.size()<2 || p_interp2.size()<2)
+	{
+		return 0;
+	}
+
+	// Geometric IoU: each stroked polyline is treated as a chain of
+	// capsules (segments dilated by lane_width/2), and per image row the
+	// covered x-intervals are intersected/merged analytically. No image
+	// buffers, no full-frame passes; cost scales with rows touched by the
+	// lanes instead of im_width*im_height.
+
+	// scratch reused across calls from the same worker thread
+	static thread_local vector<vector<pair<float, float> > > rows1, rows2;
+	if((int)rows1.size() != im_height)
+	{
+		rows1.resize(im_height);
+		rows2.resize(im_height);
 	}
 
-	if(lane2.size() == 2)
+	int row_min1 = im_height, row_max1 = -1;
+	int row_min2 = im_height, row_max2 = -1;
+	stroke_intervals(p_interp1, rows1, row_min1, row_max1);
+	stroke_intervals(p_interp2, rows2, row_min2, row_max2);
+
+	double sum_1 = 0, sum_2 = 0, inter_sum = 0;
+	for(int y=row_min1; y<=row_max1; y++)
 	{
-		p_interp2 = lane2;
+		merge_spans(rows1[y]);
+		sum_1 += union_length(rows1[y]);
 	}
-	else
+	for(int y=row_min2; y<=row_max2; y++)
+	{
+		merge_spans(rows2[y]);
+		sum_2 += union_length(rows2[y]);
+	}
+	int row_lo = max(row_min1, row_min2);
+	int row_hi = min(row_max1, row_max2);
+	for(int y=row_lo; y<=row_hi; y++)
+	{
+		inter_sum += intersection_length(rows1[y], rows2[y]);
+	}
+
+	// clear only the touched rows for the next pair
+	for(int y=row_min1; y<=row_max1; y++)
+	{
+		rows1[y].clear();
+	}
+	for(int y=row_min2; y<=row_max2; y++)
+	{
+		rows2[y].clear();
+	}
+
+	double union_sum = sum_1 + sum_2 - inter_sum;
+	if(union_sum <= 0)
+	{
+		return 0;
+	}
+	return inter_sum / union_sum;
+}
+
+vector<Point2f> LaneCompare::interp_lane(const vector<Point2f> &lane)
+{
+	if(lane.size() == 2)
+	{
+		return lane;
+	}
+	return splineSolver.splineInterpTimes(lane, 50);
+}
+
+// Collect, per image row, the x-interval covered by each capsule
+// (segment dilated by lane_width/2) of the stroked polyline. Intervals
+// are appended unmerged; the caller merges per row.
+void LaneCompare::stroke_intervals(const vector<Point2f> &p_interp, vector<vector<pair<float, float> > > &rows, int &row_min, int &row_max)
+{
+	double r = lane_width / 2.0;
+	for(size_t n=0; n+1<p_interp.size(); n++)
+	{
+		double ax = p_interp[n].x, ay = p_interp[n].y;
+		double bx = p_interp[n+1].x, by = p_interp[n+1].y;
+		double dx = bx - ax, dy = by - ay;
+
+		int y_lo = max(0, (int)ceil(min(ay, by) - r));
+		int y_hi = min(im_height - 1, (int)floor(max(ay, by) + r));
+		for(int y=y_lo; y<=y_hi; y++)
+		{
+			// x-extent of the row/capsule intersection: the capsule is the
+			// union over t in [0,1] of discs centered at A+t*(B-A); for a
+			// fixed y, each disc with |y-cy|<=r covers cx +- sqrt(r^2-(y-cy)^2),
+			// and the union of those intervals is connected.
+			double x_lo = 1e30, x_hi = -1e30;
+
+			// candidate t values: the endpoints, the row crossing the
+			// centerline, and the analytic extrema of cx +- s(t), which sit
+			// at centerline offset +-u with u = |dx| * r / |AB|
+			double cand[5];
+			int n_cand = 0;
+			cand[n_cand++] = 0;
+			cand[n_cand++] = 1;
+			if(fabs(dy) > 1e-9)
+			{
+				double seg_len = sqrt(dx*dx + dy*dy);
+				double u = fabs(dx) * r / seg_len;
+				cand[n_cand++] = (y - ay) / dy;
+				cand[n_cand++] = (y - ay - u) / dy;
+				cand[n_cand++] = (y - ay + u) / dy;
+			}
+			for(int c=0; c<n_cand; c++)
+			{
+				double t = min(1.0, max(0.0, cand[c]));
+				double cy = ay + t * dy;
+				double off = y - cy;
+				if(fabs(off) > r)
+				{
+					continue;
+				}
+				double cx = ax + t * dx;
+				double s = sqrt(r*r - off*off);
+				x_lo = min(x_lo, cx - s);
+				x_hi = max(x_hi, cx + s);
+			}
+
+			if(x_hi <= x_lo)
+			{
+				continue;
+			}
+			// clip to the image like the rasterized version does
+			x_lo = max(x_lo, 0.0);
+			x_hi = min(x_hi, (double)im_width);
+			if(x_hi <= x_lo)
+			{
+				continue;
+			}
+			rows[y].push_back(make_pair((float)x_lo, (float)x_hi));
+			row_min = min(row_min, y);
+			row_max = max(row_max, y);
+		}
+	}
+}
+
+double LaneCompare::get_lane_similarity_raster(const vector<Point2f> &lane1, const vector<Point2f> &lane2)
+{
+	if(lane1.size()<2 || lane2.size()<2)
+	{
+		cerr<<"lane size must be greater or equal to 2"<<endl;
+		return 0;
+	}
+	// Scratch arena: each worker thread keeps its two rasterization Mats
+	// across all pairs it processes. Allocating and zeroing 2 MB per pair
+	// inside the parallel evaluation loop caused measurable allocator
+	// contention; the arena is zeroed once and afterwards only the
+	// bounding box actually drawn into is cleared again.
+	static thread_local Mat im1, im2;
+	if(im1.rows != im_height || im1.cols != im_width)
+	{
+		im1 = Mat::zeros(im_height, im_width, CV_8UC1);
+		im2 = Mat::zeros(im_height, im_width, CV_8UC1);
+	}
+	// draw lines on im1 and im2
+	vector<Point2f> p_interp1 = interp_lane(lane1);
+	vector<Point2f> p_interp2 = interp_lane(lane2);
+
+	// bounding box of everything drawn, padded by the stroke width
+	float x_min = 1e30f, x_max = -1e30f, y_min = 1e30f, y_max = -1e30f;
+	for(int n=0; n<p_interp1.size(); n++)
 	{
-		p_interp2 = splineSolver.splineInterpTimes(lane2, 50);
+		x_min = min(x_min, p_interp1[n].x); x_max = max(x_max, p_interp1[n].x);
+		y_min = min(y_min, p_interp1[n].y); y_max = max(y_max, p_interp1[n].y);
 	}
-	
+	for(int n=0; n<p_interp2.size(); n++)
+	{
+		x_min = min(x_min, p_interp2[n].x); x_max = max(x_max, p_interp2[n].x);
+		y_min = min(y_min, p_interp2[n].y); y_max = max(y_max, p_interp2[n].y);
+	}
+	int box_x = max(0, (int)(x_min - lane_width));
+	int box_y = max(0, (int)(y_min - lane_width));
+	int box_w = min(im_width, (int)(x_max + lane_width) + 1) - box_x;
+	int box_h = min(im_height, (int)(y_max + lane_width) + 1) - box_y;
+	if(box_w <= 0 || box_h <= 0)
+	{
+		return 0;
+	}
+	Rect box(box_x, box_y, box_w, box_h);
+
 	Scalar color_white = Scalar(1);
 	for(int n=0; n<p_interp1.size()-1; n++)
 	{
@@ -47,10 +309,17 @@ double LaneCompare::get_lane_similarity(const vector<Point2f> &lane1, const vect
 		line(im2, p_interp2[n], p_interp2[n+1], color_white, lane_width);
 	}
 
-	double sum_1 = cv::sum(im1).val[0];
-	double sum_2 = cv::sum(im2).val[0];
-	double inter_sum = cv::sum(im1.mul(im2)).val[0];
-	double union_sum = sum_1 + sum_2 - inter_sum; 
+	Mat roi1 = im1(box);
+	Mat roi2 = im2(box);
+	double sum_1 = cv::sum(roi1).val[0];
+	double sum_2 = cv::sum(roi2).val[0];
+	double inter_sum = cv::sum(roi1.mul(roi2)).val[0];
+	double union_sum = sum_1 + sum_2 - inter_sum;
+
+	// reset only what was touched, ready for the next pair
+	roi1.setTo(Scalar(0));
+	roi2.setTo(Scalar(0));
+
 	double iou = inter_sum / union_sum;
 	return iou;
 }
@@ -70,4 +339,3 @@ void LaneCompare::resize_lane(vector<Point2f> &curr_lane, int curr_width, int cu
 		curr_lane[n] = Point2f(curr_lane[n].x*x_scale, curr_lane[n].y*y_scale);
 	}
 }
-
@@ -0,0 +1,470 @@
+/*************************************************************************
+	> File Name: lane_io.cpp
+	> Memory-mapped lane file reading for the evaluator hot path.
+ ************************************************************************/
+
+#include "lane_io.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+namespace
+{
+	// Scans one float from [p, end): optional sign, digits, optional
+	// fraction, optional e/E exponent. Returns the character after the
+	// number, or NULL if no number starts at the first non-blank
+	// position. An order of magnitude faster than stringstream
+	// extraction because there is no locale machinery and no
+	// per-character virtual dispatch.
+	const char *parse_float(const char *p, const char *end, float &out)
+	{
+		while(p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+		{
+			p++;
+		}
+		if(p >= end)
+		{
+			return NULL;
+		}
+		bool neg = false;
+		if(*p == '-' || *p == '+')
+		{
+			neg = (*p == '-');
+			p++;
+		}
+		if(p >= end || ((*p < '0' || *p > '9') && *p != '.'))
+		{
+			return NULL;
+		}
+		double value = 0;
+		while(p < end && *p >= '0' && *p <= '9')
+		{
+			value = value * 10 + (*p - '0');
+			p++;
+		}
+		if(p < end && *p == '.')
+		{
+			p++;
+			double scale = 0.1;
+			while(p < end && *p >= '0' && *p <= '9')
+			{
+				value += (*p - '0') * scale;
+				scale *= 0.1;
+				p++;
+			}
+		}
+		if(p < end && (*p == 'e' || *p == 'E'))
+		{
+			// exponent is only consumed when digits follow; a bare 'e'
+			// stays in the stream like strtod would leave it
+			const char *exp_start = p;
+			p++;
+			bool exp_neg = false;
+			if(p < end && (*p == '-' || *p == '+'))
+			{
+				exp_neg = (*p == '-');
+				p++;
+			}
+			if(p < end && *p >= '0' && *p <= '9')
+			{
+				int exp = 0;
+				while(p < end && *p >= '0' && *p <= '9')
+				{
+					exp = exp * 10 + (*p - '0');
+					p++;
+				}
+				value *= pow(10.0, exp_neg ? -exp : exp);
+			}
+			else
+			{
+				p = exp_start;
+			}
+		}
+		out = (float)(neg ? -value : value);
+		return p;
+	}
+}
+
+#if __linux__
+
+void read_lane_file_mmap(const string &file_name, vector<vector<Point2f> > &lanes)
+{
+	lanes.clear();
+
+	int fd = open(file_name.c_str(), O_RDONLY);
+	if(fd < 0)
+	{
+		return;
+	}
+	struct stat st;
+	if(fstat(fd, &st) < 0 || st.st_size == 0)
+	{
+		close(fd);
+		return;
+	}
+	const char *data = (const char *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED)
+	{
+		return;
+	}
+	const char *p = data;
+	const char *end = data + st.st_size;
+
+	// arena reused across files by this worker thread
+	static thread_local vector<Point2f> arena;
+
+	while(p < end)
+	{
+		const char *line_end = p;
+		while(line_end < end && *line_end != '\n')
+		{
+			line_end++;
+		}
+		arena.clear();
+		const char *q = p;
+		float x, y;
+		while(q && q < line_end)
+		{
+			q = parse_float(q, line_end, x);
+			if(!q)
+			{
+				break;
+			}
+			q = parse_float(q, line_end, y);
+			if(!q)
+			{
+				break;
+			}
+			arena.push_back(Point2f(x, y));
+		}
+		// one lane per line, empty lines included, matching getline()
+		lanes.push_back(vector<Point2f>(arena.begin(), arena.end()));
+		p = line_end + 1;
+	}
+
+	munmap((void *)data, st.st_size);
+}
+
+unsigned long long hash_file_fnv1a(const string &file_name)
+{
+	int fd = open(file_name.c_str(), O_RDONLY);
+	if(fd < 0)
+	{
+		return 0;
+	}
+	struct stat st;
+	if(fstat(fd, &st) < 0 || st.st_size == 0)
+	{
+		close(fd);
+		return 0;
+	}
+	const unsigned char *data = (const unsigned char *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED)
+	{
+		return 0;
+	}
+	unsigned long long h = 14695981039346656037ULL;
+	for(off_t n=0; n<st.st_size; n++)
+	{
+		h ^= data[n];
+		h *= 1099511628211ULL;
+	}
+	munmap((void *)data, st.st_size);
+	return h;
+}
+
+#else
+
+// Portable fallback: the old ifstream/stringstream reader.
+void read_lane_file_mmap(const string &file_name, vector<vector<Point2f> > &lanes)
+{
+	lanes.clear();
+	ifstream ifs_lane(file_name, ios::in);
+	if(ifs_lane.fail())
+	{
+		return;
+	}
+	string str_line;
+	while(getline(ifs_lane, str_line))
+	{
+		vector<Point2f> curr_lane;
+		stringstream ss;
+		ss<<str_line;
+		double x,y;
+		while(ss>>x>>y)
+		{
+			curr_lane.push_back(Point2f(x, y));
+		}
+		lanes.push_back(curr_lane);
+	}
+	ifs_lane.close();
+}
+
+unsigned long long hash_file_fnv1a(const string &file_name)
+{
+	ifstream ifs(file_name, ios::in | ios::binary);
+	if(ifs.fail())
+	{
+		return 0;
+	}
+	unsigned long long h = 14695981039346656037ULL;
+	char c;
+	bool any = false;
+	while(ifs.get(c))
+	{
+		h ^= (unsigned char)c;
+		h *= 1099511628211ULL;
+		any = true;
+	}
+	return any ? h : 0;
+}
+
+#endif
+
+// ---- binary columnar lane pack ----
+
+namespace
+{
+	const char kPackMagic[4] = {'L', 'P', 'K', '1'};
+
+	// unaligned little-endian reads out of the mapped pack
+	unsigned read_u32(const unsigned char *p)
+	{
+		unsigned v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	unsigned long long read_u64(const unsigned char *p)
+	{
+		unsigned long long v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+}
+
+LanePack::~LanePack()
+{
+#if __linux__
+	if(data_)
+	{
+		munmap((void *)data_, size_);
+	}
+#else
+	delete[] data_;
+#endif
+}
+
+bool LanePack::open(const string &path)
+{
+#if __linux__
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+	{
+		return false;
+	}
+	struct stat st;
+	if(fstat(fd, &st) < 0 || st.st_size < 8)
+	{
+		close(fd);
+		return false;
+	}
+	size_ = st.st_size;
+	data_ = (const unsigned char *)mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data_ == MAP_FAILED)
+	{
+		data_ = NULL;
+		return false;
+	}
+#else
+	ifstream ifs(path, ios::in | ios::binary | ios::ate);
+	if(ifs.fail())
+	{
+		return false;
+	}
+	size_ = ifs.tellg();
+	if(size_ < 8)
+	{
+		return false;
+	}
+	unsigned char *buf = new unsigned char[size_];
+	ifs.seekg(0, ios::beg);
+	ifs.read((char *)buf, size_);
+	data_ = buf;
+#endif
+
+	if(memcmp(data_, kPackMagic, 4) != 0)
+	{
+		cerr<<"lane pack "<<path<<": bad magic"<<endl;
+		return false;
+	}
+	unsigned image_count = read_u32(data_ + 4);
+	const unsigned char *rec = data_ + 8;
+	const size_t rec_size = 8 + 4 + 8 + 4;
+	const size_t lane_rec_size = 8 + 4;
+	if(8 + (size_t)image_count * rec_size > size_)
+	{
+		cerr<<"lane pack "<<path<<": truncated index"<<endl;
+		return false;
+	}
+	// Validate every offset/length sum here, phrased to dodge unsigned
+	// overflow: a truncated or corrupt pack must fail open(), not
+	// segfault inside the parallel evaluation loop.
+	index_.reserve(image_count);
+	for(unsigned i=0; i<image_count; i++, rec += rec_size)
+	{
+		unsigned long long name_off = read_u64(rec);
+		unsigned name_len = read_u32(rec + 8);
+		unsigned long long lane_off = read_u64(rec + 12);
+		unsigned lane_count = read_u32(rec + 20);
+		if(name_off > size_ || name_len > size_ - name_off)
+		{
+			cerr<<"lane pack "<<path<<": bad name record"<<endl;
+			return false;
+		}
+		if(lane_off > size_ || (unsigned long long)lane_count * lane_rec_size > size_ - lane_off)
+		{
+			cerr<<"lane pack "<<path<<": bad lane record"<<endl;
+			return false;
+		}
+		for(unsigned n=0; n<lane_count; n++)
+		{
+			const unsigned char *lane_rec = data_ + lane_off + n * lane_rec_size;
+			unsigned long long point_off = read_u64(lane_rec);
+			unsigned long long point_bytes =
+					(unsigned long long)read_u32(lane_rec + 8) * 2 * sizeof(float);
+			if(point_off > size_ || point_bytes > size_ - point_off)
+			{
+				cerr<<"lane pack "<<path<<": bad point record"<<endl;
+				return false;
+			}
+		}
+		string key((const char *)data_ + name_off, name_len);
+		index_[key] = make_pair(lane_off, lane_count);
+	}
+	return true;
+}
+
+bool LanePack::get(const string &key, vector<vector<Point2f> > &lanes) const
+{
+	lanes.clear();
+	auto it = index_.find(key);
+	if(it == index_.end())
+	{
+		return false;
+	}
+	unsigned long long lane_off = it->second.first;
+	unsigned lane_count = it->second.second;
+	const size_t lane_rec_size = 8 + 4;
+	lanes.resize(lane_count);
+	for(unsigned n=0; n<lane_count; n++)
+	{
+		const unsigned char *rec = data_ + lane_off + n * lane_rec_size;
+		unsigned long long point_off = read_u64(rec);
+		unsigned point_count = read_u32(rec + 8);
+		lanes[n].resize(point_count);
+		// float32 x,y pairs, copied straight out of the mapping; the
+		// lane and point ranges were bounds-checked in open()
+		memcpy(lanes[n].data(), data_ + point_off, (size_t)point_count * 2 * sizeof(float));
+	}
+	return true;
+}
+
+bool write_lane_pack(const string &path, const vector<string> &keys,
+		const vector<vector<vector<Point2f> > > &lanes)
+{
+	if(keys.size() != lanes.size())
+	{
+		return false;
+	}
+	ofstream ofs(path, ios::out | ios::binary);
+	if(ofs.fail())
+	{
+		return false;
+	}
+
+	const size_t rec_size = 8 + 4 + 8 + 4;
+	const size_t lane_rec_size = 8 + 4;
+
+	// lay the sections out: header, image index, lane records, points, names
+	unsigned long long lane_base = 8 + keys.size() * rec_size;
+	unsigned long long total_lanes = 0, total_points = 0;
+	for(size_t i=0; i<lanes.size(); i++)
+	{
+		total_lanes += lanes[i].size();
+		for(size_t n=0; n<lanes[i].size(); n++)
+		{
+			total_points += lanes[i][n].size();
+		}
+	}
+	unsigned long long point_base = lane_base + total_lanes * lane_rec_size;
+	unsigned long long name_base = point_base + total_points * 2 * sizeof(float);
+
+	ofs.write(kPackMagic, 4);
+	unsigned image_count = keys.size();
+	ofs.write((const char *)&image_count, 4);
+
+	// image index
+	unsigned long long lane_off = lane_base;
+	unsigned long long name_off = name_base;
+	for(size_t i=0; i<keys.size(); i++)
+	{
+		unsigned name_len = keys[i].size();
+		unsigned lane_count = lanes[i].size();
+		ofs.write((const char *)&name_off, 8);
+		ofs.write((const char *)&name_len, 4);
+		ofs.write((const char *)&lane_off, 8);
+		ofs.write((const char *)&lane_count, 4);
+		name_off += name_len;
+		lane_off += (unsigned long long)lane_count * lane_rec_size;
+	}
+
+	// lane records
+	unsigned long long point_off = point_base;
+	for(size_t i=0; i<lanes.size(); i++)
+	{
+		for(size_t n=0; n<lanes[i].size(); n++)
+		{
+			unsigned point_count = lanes[i][n].size();
+			ofs.write((const char *)&point_off, 8);
+			ofs.write((const char *)&point_count, 4);
+			point_off += (unsigned long long)point_count * 2 * sizeof(float);
+		}
+	}
+
+	// point payload
+	for(size_t i=0; i<lanes.size(); i++)
+	{
+		for(size_t n=0; n<lanes[i].size(); n++)
+		{
+			if(!lanes[i][n].empty())
+			{
+				ofs.write((const char *)lanes[i][n].data(),
+						lanes[i][n].size() * 2 * sizeof(float));
+			}
+		}
+	}
+
+	// name blob
+	for(size_t i=0; i<keys.size(); i++)
+	{
+		ofs.write(keys[i].data(), keys[i].size());
+	}
+
+	return ofs.good();
+}
@@ -6,6 +6,12 @@ using namespace cv;
 
 vector<Point2f> Spline::splineInterpTimes(const vector<Point2f>& tmp_line, int times) {
     vector<Point2f> res;
+    splineInterpTimesInto(tmp_line, times, res);
+    return res;
+}
+
+void Spline::splineInterpTimesInto(const vector<Point2f>& tmp_line, int times, vector<Point2f>& res) {
+    res.clear();
 
     if(tmp_line.size() == 2) {
         double x1 = tmp_line[0].x;
@@ -13,10 +19,11 @@ vector<Point2f> Spline::splineInterpTimes(const vector<Point2f>& tmp_line, int t
         double x2 = tmp_line[1].x;
         double y2 = tmp_line[1].y;
 
+        res.resize(times + 1);
         for (int k = 0; k <= times; k++) {
             double xi =  x1 + double((x2 - x1) * k) / times;
             double yi =  y1 + double((y2 - y1) * k) / times;
-            res.push_back(Point2f(xi, yi));
+            res[k] = Point2f(xi, yi);
         }
     }
 
@@ -26,25 +33,31 @@ vector<Point2f> Spline::splineInterpTimes(const vector<Point2f>& tmp_line, int t
         tmp_func = this->cal_fun(tmp_line);
         if (tmp_func.empty()) {
             cout << "in splineInterpTimes: cal_fun failed" << endl;
-            return res;
+            return;
         }
+        res.resize(tmp_func.size() * times + 1);
         for(int j = 0; j < tmp_func.size(); j++)
         {
             double delta = tmp_func[j].h / times;
+            double a_x = tmp_func[j].a_x, b_x = tmp_func[j].b_x, c_x = tmp_func[j].c_x, d_x = tmp_func[j].d_x;
+            double a_y = tmp_func[j].a_y, b_y = tmp_func[j].b_y, c_y = tmp_func[j].c_y, d_y = tmp_func[j].d_y;
+            Point2f *out = &res[j * times];
+            // Horner form, no pow() calls; the sample loop has no
+            // dependences, so the compiler can vectorize it (AVX2/NEON)
+#pragma omp simd
             for(int k = 0; k < times; k++)
             {
                 double t1 = delta*k;
-                double x1 = tmp_func[j].a_x + tmp_func[j].b_x*t1 + tmp_func[j].c_x*pow(t1,2) + tmp_func[j].d_x*pow(t1,3);
-                double y1 = tmp_func[j].a_y + tmp_func[j].b_y*t1 + tmp_func[j].c_y*pow(t1,2) + tmp_func[j].d_y*pow(t1,3);
-                res.push_back(Point2f(x1, y1));
+                double x1 = ((d_x*t1 + c_x)*t1 + b_x)*t1 + a_x;
+                double y1 = ((d_y*t1 + c_y)*t1 + b_y)*t1 + a_y;
+                out[k] = Point2f(x1, y1);
             }
         }
-        res.push_back(tmp_line[tmp_line.size() - 1]);
+        res[tmp_func.size() * times] = tmp_line[tmp_line.size() - 1];
     }
 	else {
 		cerr << "in splineInterpTimes: not enough points" << endl;
 	}
-    return res;
 }
 vector<Point2f> Spline::splineInterpStep(vector<Point2f> tmp_line, double step) {
 	vector<Point2f> res;
@@ -0,0 +1,299 @@
+/*************************************************************************
+	> File Name: lane_bench.cpp
+	> Synthetic-workload benchmarks for the evaluator hot paths: spline
+	> interpolation, lane IoU, assignment matching and count_im_pair
+	> end-to-end. Reports ns/op and optionally checks against a stored
+	> baseline so CI can fail on regressions.
+ ************************************************************************/
+
+#include "counter.hpp"
+#include "spline.hpp"
+#include "hungarianGraph.hpp"
+#if __linux__
+#include <unistd.h>
+#elif _MSC_VER
+#include "getopt.h"
+#endif
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include <map>
+using namespace std;
+using namespace cv;
+
+void help(void)
+{
+	cout<<"./lane_bench [OPTIONS]"<<endl;
+	cout<<"-h                  : print usage help"<<endl;
+	cout<<"-n                  : lanes per image (default: 4)"<<endl;
+	cout<<"-p                  : points per lane (default: 30)"<<endl;
+	cout<<"-c                  : image width (default: 1920)"<<endl;
+	cout<<"-r                  : image height (default: 1080)"<<endl;
+	cout<<"-i                  : iterations per benchmark (default: 2000)"<<endl;
+	cout<<"-b                  : baseline file to compare ns/op against"<<endl;
+	cout<<"-u                  : update (write) the baseline file instead of comparing"<<endl;
+	cout<<"-T                  : allowed regression over baseline (default: 0.15 = 15%)"<<endl;
+}
+
+// Deterministic xorshift64 generator so every run (and every machine)
+// benchmarks the exact same workload.
+struct Rng
+{
+	unsigned long long s;
+	Rng(unsigned long long seed) : s(seed) {}
+	unsigned long long next()
+	{
+		s ^= s << 13;
+		s ^= s >> 7;
+		s ^= s << 17;
+		return s;
+	}
+	// uniform in [lo, hi)
+	double uniform(double lo, double hi)
+	{
+		return lo + (next() >> 11) * (1.0 / 9007199254740992.0) * (hi - lo);
+	}
+};
+
+// One synthetic lane: a gently curved polyline running bottom-up, the
+// shape real CULane annotations have after resize_lane.
+vector<Point2f> gen_lane(Rng &rng, int points_per_lane, int im_width, int im_height)
+{
+	double x0 = rng.uniform(0.2, 0.8) * im_width;
+	double slope = rng.uniform(-0.4, 0.4);
+	double curve = rng.uniform(-3e-4, 3e-4);
+	double y_top = rng.uniform(0.3, 0.5) * im_height;
+
+	vector<Point2f> lane(points_per_lane);
+	for(int n=0; n<points_per_lane; n++)
+	{
+		double y = im_height - 1 - n * (im_height - 1 - y_top) / (points_per_lane - 1);
+		double dy = im_height - 1 - y;
+		double x = x0 + slope * dy + curve * dy * dy;
+		lane[n] = Point2f((float)x, (float)y);
+	}
+	return lane;
+}
+
+// Detection lanes are jittered copies of the annotations so the matcher
+// and IoU see realistic near-matches rather than disjoint strokes.
+vector<Point2f> perturb_lane(Rng &rng, const vector<Point2f> &lane)
+{
+	vector<Point2f> out(lane.size());
+	float shift = (float)rng.uniform(-4.0, 4.0);
+	for(size_t n=0; n<lane.size(); n++)
+	{
+		out[n] = Point2f(lane[n].x + shift + (float)rng.uniform(-2.0, 2.0), lane[n].y);
+	}
+	return out;
+}
+
+static double sink = 0;  // keeps the measured calls observable
+
+double now_ns(void)
+{
+	return chrono::duration<double, nano>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void report(const string &name, double ns_per_op, map<string, double> &results)
+{
+	results[name] = ns_per_op;
+	cout<<name<<": "<<(long)ns_per_op<<" ns/op"<<endl;
+}
+
+int main(int argc, char **argv)
+{
+	int lanes_per_image = 4;
+	int points_per_lane = 30;
+	int im_width = 1920;
+	int im_height = 1080;
+	int iterations = 2000;
+	string baseline_file = "";
+	bool update_baseline = false;
+	double tolerance = 0.15;
+	int oc;
+	while((oc = getopt(argc, argv, "hn:p:c:r:i:b:uT:")) != -1)
+	{
+		switch(oc)
+		{
+			case 'h':
+				help();
+				return 0;
+			case 'n':
+				lanes_per_image = atoi(optarg);
+				break;
+			case 'p':
+				points_per_lane = atoi(optarg);
+				break;
+			case 'c':
+				im_width = atoi(optarg);
+				break;
+			case 'r':
+				im_height = atoi(optarg);
+				break;
+			case 'i':
+				iterations = atoi(optarg);
+				break;
+			case 'b':
+				baseline_file = optarg;
+				break;
+			case 'u':
+				update_baseline = true;
+				break;
+			case 'T':
+				tolerance = atof(optarg);
+				break;
+		}
+	}
+
+	cout<<"------------Configuration---------"<<endl;
+	cout<<"lanes_per_image: "<<lanes_per_image<<endl;
+	cout<<"points_per_lane: "<<points_per_lane<<endl;
+	cout<<"im_width: "<<im_width<<endl;
+	cout<<"im_height: "<<im_height<<endl;
+	cout<<"iterations: "<<iterations<<endl;
+	cout<<"-----------------------------------"<<endl;
+
+	// fixed seed: identical workload on every run
+	Rng rng(0x9e3779b97f4a7c15ULL);
+
+	// pre-generate one pool of images so generation cost stays outside
+	// the timed loops
+	const int pool = 64;
+	vector<vector<vector<Point2f> > > annos(pool), detects(pool);
+	for(int i=0; i<pool; i++)
+	{
+		annos[i].resize(lanes_per_image);
+		detects[i].resize(lanes_per_image);
+		for(int n=0; n<lanes_per_image; n++)
+		{
+			annos[i][n] = gen_lane(rng, points_per_lane, im_width, im_height);
+			detects[i][n] = perturb_lane(rng, annos[i][n]);
+		}
+	}
+
+	map<string, double> results;
+	LaneCompare lane_compare(im_width, im_height, 10, LaneCompare::IOU);
+	Spline splineSolver;
+
+	// --- spline interpolation
+	{
+		double t0 = now_ns();
+		long ops = 0;
+		for(int it=0; it<iterations; it++)
+		{
+			const vector<vector<Point2f> > &im = annos[it % pool];
+			for(size_t n=0; n<im.size(); n++)
+			{
+				vector<Point2f> p_interp = splineSolver.splineInterpTimes(im[n], 50);
+				sink += p_interp.back().x;
+				ops++;
+			}
+		}
+		report("spline_interp", (now_ns() - t0) / ops, results);
+	}
+
+	// --- lane IoU (interpolation included, as count_im_pair pays it)
+	{
+		double t0 = now_ns();
+		long ops = 0;
+		for(int it=0; it<iterations; it++)
+		{
+			const vector<vector<Point2f> > &anno = annos[it % pool];
+			const vector<vector<Point2f> > &detect = detects[it % pool];
+			for(size_t n=0; n<anno.size(); n++)
+			{
+				sink += lane_compare.get_lane_similarity(anno[n], detect[n]);
+				ops++;
+			}
+		}
+		report("lane_iou", (now_ns() - t0) / ops, results);
+	}
+
+	// --- assignment matching on dense similarity matrices
+	{
+		vector<vector<double> > similarity(lanes_per_image, vector<double>(lanes_per_image));
+		for(int i=0; i<lanes_per_image; i++)
+		{
+			for(int j=0; j<lanes_per_image; j++)
+			{
+				similarity[i][j] = rng.uniform(0.0, 1.0);
+			}
+		}
+		AssignmentSolver solver;
+		vector<int> match1, match2;
+		double t0 = now_ns();
+		for(int it=0; it<iterations; it++)
+		{
+			solver.solve(similarity, false, match1, match2);
+			sink += match1[0];
+		}
+		report("assignment", (now_ns() - t0) / iterations, results);
+	}
+
+	// --- end-to-end per-image pipeline
+	{
+		Counter counter(im_width, im_height, 0.4, 10);
+		double t0 = now_ns();
+		for(int it=0; it<iterations; it++)
+		{
+			tuple<vector<int>, long, long, long, long> result =
+					counter.count_im_pair(annos[it % pool], detects[it % pool]);
+			sink += get<1>(result);
+		}
+		report("count_im_pair", (now_ns() - t0) / iterations, results);
+	}
+
+	if(baseline_file.empty())
+	{
+		return 0;
+	}
+
+	if(update_baseline)
+	{
+		ofstream ofs(baseline_file, ios::out);
+		if(ofs.fail())
+		{
+			cerr<<"Error: cannot write baseline "<<baseline_file<<endl;
+			return 1;
+		}
+		for(map<string, double>::iterator it=results.begin(); it!=results.end(); ++it)
+		{
+			ofs<<it->first<<" "<<it->second<<"\n";
+		}
+		cout<<"baseline written to "<<baseline_file<<endl;
+		return 0;
+	}
+
+	ifstream ifs(baseline_file, ios::in);
+	if(ifs.fail())
+	{
+		cerr<<"Error: baseline file "<<baseline_file<<" not exist! (use -u to create it)"<<endl;
+		return 1;
+	}
+	int regressions = 0;
+	string name;
+	double base_ns;
+	while(ifs>>name>>base_ns)
+	{
+		if(results.find(name) == results.end())
+		{
+			continue;
+		}
+		double ratio = results[name] / base_ns;
+		if(ratio > 1.0 + tolerance)
+		{
+			cerr<<"REGRESSION "<<name<<": "<<(long)results[name]<<" ns/op vs baseline "
+				<<(long)base_ns<<" ("<<(long)((ratio - 1.0) * 100)<<"% slower)"<<endl;
+			regressions++;
+		}
+		else
+		{
+			cout<<name<<": within baseline ("<<(long)base_ns<<" ns/op, x"<<ratio<<")"<<endl;
+		}
+	}
+	return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+/*************************************************************************
+	> File Name: lane_pack.cpp
+	> Converts a directory of per-image .lines.txt files into one binary
+	> lane pack (see lane_io.hpp) consumed by evaluate via -A/-D.
+ ************************************************************************/
+
+#include "lane_io.hpp"
+#if __linux__
+#include <unistd.h>
+#elif _MSC_VER
+#include "getopt.h"
+#endif
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+using namespace std;
+using namespace cv;
+
+void help(void)
+{
+	cout<<"./lane_pack [OPTIONS]"<<endl;
+	cout<<"-h                  : print usage help"<<endl;
+	cout<<"-l                  : list of images, same file passed to evaluate -l"<<endl;
+	cout<<"-s                  : source directory of .lines.txt files (the evaluate -a or -d directory)"<<endl;
+	cout<<"-o                  : output pack file (default: ./lanes.pack)"<<endl;
+}
+
+int main(int argc, char **argv)
+{
+	string list_im_file = "";
+	string label_dir = "";
+	string output_file = "./lanes.pack";
+	int oc;
+	while((oc = getopt(argc, argv, "hl:s:o:")) != -1)
+	{
+		switch(oc)
+		{
+			case 'h':
+				help();
+				return 0;
+			case 'l':
+				list_im_file = optarg;
+				break;
+			case 's':
+				label_dir = optarg;
+				break;
+			case 'o':
+				output_file = optarg;
+				break;
+		}
+	}
+
+	if(list_im_file.empty() || label_dir.empty())
+	{
+		help();
+		return 1;
+	}
+
+	ifstream ifs_im_list(list_im_file, ios::in);
+	if(ifs_im_list.fail())
+	{
+		cerr<<"Error: file "<<list_im_file<<" not exist!"<<endl;
+		return 1;
+	}
+
+	// keys must match what evaluate derives from the same filelist
+	vector<string> keys;
+	string sub_im_name;
+	while(getline(ifs_im_list, sub_im_name))
+	{
+		keys.push_back(sub_im_name.substr(0, sub_im_name.find_last_of(".")) + ".lines.txt");
+	}
+	ifs_im_list.close();
+
+	vector<vector<vector<Point2f> > > lanes(keys.size());
+	long total_lanes = 0;
+	for(size_t i=0; i<keys.size(); i++)
+	{
+		read_lane_file_mmap(label_dir + keys[i], lanes[i]);
+		total_lanes += lanes[i].size();
+	}
+
+	if(!write_lane_pack(output_file, keys, lanes))
+	{
+		cerr<<"Error: cannot write pack "<<output_file<<endl;
+		return 1;
+	}
+	cout<<"packed "<<keys.size()<<" images ("<<total_lanes<<" lanes) into "<<output_file<<endl;
+	return 0;
+}
@@ -0,0 +1,210 @@
+#ifndef TELEMETRY_BUS_HPP
+#define TELEMETRY_BUS_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Shared-memory telemetry bus between the lane detector process and the
+// ADAS display. Single writer, any number of readers.
+//
+// Transport is a POSIX shm segment holding a seqlock-style ring of
+// fixed-size records: the writer bumps a slot's sequence to odd, writes
+// the payload, bumps it back to even, then publishes the slot index.
+// Readers retry a slot whose sequence was odd or changed mid-read, so
+// neither side ever blocks and a stalled display cannot back-pressure
+// the detector. A named FIFO carries one wakeup byte per publish; the
+// display wraps that fd in a QSocketNotifier instead of polling.
+//
+// This header is the protocol: both processes compile against it and
+// nothing else is shared.
+namespace telemetry
+{
+
+const char kShmName[] = "/adas_telemetry";
+const char kFifoPath[] = "/tmp/adas_telemetry.fifo";
+
+// One lane-detection result. Plain scalars only; the struct is copied
+// through shared memory as raw bytes.
+struct Record
+{
+    unsigned frame_id;
+    unsigned lane_count;
+    float lane_offset_px;        // lane-centre offset from image centre, +right
+    unsigned char departure;     // 1 when the offset passes the warning threshold
+    unsigned long long timestamp_us;
+};
+
+struct Slot
+{
+    std::atomic<unsigned> seq;   // even: stable, odd: writer inside
+    Record record;
+};
+
+const unsigned kSlots = 64;
+
+struct Bus
+{
+    std::atomic<unsigned> head;  // slot index of the most recent publish
+    Slot slots[kSlots];
+};
+
+class Publisher
+{
+public:
+    Publisher() : bus_(NULL), fifo_fd_(-1), next_(0) {}
+
+    ~Publisher()
+    {
+        if (bus_)
+            munmap(bus_, sizeof(Bus));
+        if (fifo_fd_ >= 0)
+            close(fifo_fd_);
+    }
+
+    // Creates (or reuses) the shm segment and the wakeup FIFO. The FIFO
+    // end stays unconnected until a reader appears; publish() keeps
+    // retrying it without blocking.
+    bool open()
+    {
+        int fd = shm_open(kShmName, O_CREAT | O_RDWR, 0666);
+        if (fd < 0)
+            return false;
+        if (ftruncate(fd, sizeof(Bus)) < 0)
+        {
+            close(fd);
+            return false;
+        }
+        bus_ = (Bus *)mmap(NULL, sizeof(Bus), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (bus_ == MAP_FAILED)
+        {
+            bus_ = NULL;
+            return false;
+        }
+        mkfifo(kFifoPath, 0666);  // EEXIST is fine
+        // a reader closing its end must surface as EPIPE, not kill us
+        signal(SIGPIPE, SIG_IGN);
+        fifo_fd_ = ::open(kFifoPath, O_WRONLY | O_NONBLOCK);  // -1 until a reader opens it
+        return true;
+    }
+
+    bool is_open() const { return bus_ != NULL; }
+
+    void publish(const Record &record)
+    {
+        if (!bus_)
+            return;
+        unsigned slot_idx = next_ % kSlots;
+        Slot &slot = bus_->slots[slot_idx];
+        slot.seq.fetch_add(1, std::memory_order_acq_rel);  // odd: in progress
+        slot.record = record;
+        slot.seq.fetch_add(1, std::memory_order_release);  // even: stable
+        bus_->head.store(slot_idx, std::memory_order_release);
+        next_++;
+
+        if (fifo_fd_ < 0)
+            fifo_fd_ = ::open(kFifoPath, O_WRONLY | O_NONBLOCK);
+        if (fifo_fd_ >= 0)
+        {
+            char byte = 1;
+            if (write(fifo_fd_, &byte, 1) < 0 && errno == EPIPE)
+            {
+                // reader went away; reconnect on the next publish
+                close(fifo_fd_);
+                fifo_fd_ = -1;
+            }
+        }
+    }
+
+private:
+    Bus *bus_;
+    int fifo_fd_;
+    unsigned next_;
+};
+
+class Subscriber
+{
+public:
+    Subscriber() : bus_(NULL), fifo_fd_(-1) {}
+
+    ~Subscriber()
+    {
+        if (bus_)
+            munmap((void *)bus_, sizeof(Bus));
+        if (fifo_fd_ >= 0)
+            close(fifo_fd_);
+    }
+
+    // Attaches to an existing segment; fails until the detector has
+    // created it.
+    bool open()
+    {
+        int fd = shm_open(kShmName, O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+        bus_ = (const Bus *)mmap(NULL, sizeof(Bus), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (bus_ == MAP_FAILED)
+        {
+            bus_ = NULL;
+            return false;
+        }
+        fifo_fd_ = ::open(kFifoPath, O_RDONLY | O_NONBLOCK);
+        return fifo_fd_ >= 0;
+    }
+
+    bool is_open() const { return bus_ != NULL && fifo_fd_ >= 0; }
+
+    // Readable whenever the writer published since the last drain; hand
+    // it to QSocketNotifier / poll().
+    int notification_fd() const { return fifo_fd_; }
+
+    // Empties pending wakeup bytes so the fd only signals again on the
+    // next publish.
+    void drain() const
+    {
+        char buf[64];
+        while (fifo_fd_ >= 0 && read(fifo_fd_, buf, sizeof(buf)) > 0)
+        {
+        }
+    }
+
+    // Seqlock read of the most recent record; false only before the
+    // first publish or while the writer is mid-update for too long.
+    bool latest(Record &record) const
+    {
+        if (!bus_)
+            return false;
+        for (int attempt = 0; attempt < 16; attempt++)
+        {
+            unsigned slot_idx = bus_->head.load(std::memory_order_acquire) % kSlots;
+            const Slot &slot = bus_->slots[slot_idx];
+            unsigned seq0 = slot.seq.load(std::memory_order_acquire);
+            if (seq0 == 0 || (seq0 & 1))
+                continue;
+            Record copy = slot.record;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            unsigned seq1 = slot.seq.load(std::memory_order_relaxed);
+            if (seq0 == seq1)
+            {
+                record = copy;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const Bus *bus_;
+    int fifo_fd_;
+};
+
+}  // namespace telemetry
+
+#endif  // TELEMETRY_BUS_HPP